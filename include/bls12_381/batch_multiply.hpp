@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBEDDED_PAIRING_BLS12_381_BATCH_MULTIPLY_HPP_
+#define EMBEDDED_PAIRING_BLS12_381_BATCH_MULTIPLY_HPP_
+
+#include <stddef.h>
+#include "core/bigint.hpp"
+#include "bls12_381/curve.hpp"
+
+namespace embedded_pairing::bls12_381 {
+    /*
+     * Sets results[i] to scalar times bases[i], for i < N. This is faster
+     * than multiplying each base separately: the scalar is decomposed and
+     * recoded only once, and the tables of multiples of the bases are built
+     * in affine coordinates for many bases at a time, sharing one field
+     * inversion per step (Montgomery's trick), so that the additions are
+     * mixed additions. RESULTS may be the same array as BASES.
+     */
+    void batch_multiply(G1* results, const G1* bases, size_t n, const BigInt<256>& scalar);
+    void batch_multiply(G1Affine* results, const G1Affine* bases, size_t n, const BigInt<256>& scalar);
+    void batch_multiply(G2* results, const G2* bases, size_t n, const BigInt<256>& scalar);
+    void batch_multiply(G2Affine* results, const G2Affine* bases, size_t n, const BigInt<256>& scalar);
+}
+
+#endif
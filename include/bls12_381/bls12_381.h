@@ -106,6 +106,8 @@ typedef struct {
     size_t _coeff_idx;
 } embedded_pairing_bls12_381_prepared_pair_t;
 
+typedef void (*embedded_pairing_bls12_381_parallel_for_t)(void* executor, void (*task)(void*, size_t), void* arg, size_t count);
+
 extern const embedded_pairing_core_bigint_256_t* embedded_pairing_bls12_381_group_order;
 
 extern const embedded_pairing_bls12_381_g1_t* embedded_pairing_bls12_381_g1_zero;
@@ -164,13 +166,17 @@ bool embedded_pairing_bls12_381_gt_equal(const embedded_pairing_bls12_381_fq12_t
 
 void embedded_pairing_bls12_381_pairing(embedded_pairing_bls12_381_fq12_t* result, const embedded_pairing_bls12_381_g1affine_t* a, const embedded_pairing_bls12_381_g2affine_t* b);
 void embedded_pairing_bls12_381_prepared_pairing(embedded_pairing_bls12_381_fq12_t* result, const embedded_pairing_bls12_381_g1affine_t* a, const embedded_pairing_bls12_381_g2prepared_t* b);
+void embedded_pairing_bls12_381_pairing_batch(embedded_pairing_bls12_381_fq12_t* results, const embedded_pairing_bls12_381_g1affine_t* a, const embedded_pairing_bls12_381_g2affine_t* b, size_t n);
 void embedded_pairing_bls12_381_pairing_sum(embedded_pairing_bls12_381_fq12_t* result, embedded_pairing_bls12_381_affine_pair_t* affine_pairs, size_t num_affine_pairs, embedded_pairing_bls12_381_prepared_pair_t* prepared_pairs, size_t num_prepared_pairs);
+void embedded_pairing_bls12_381_pairing_sum_parallel(embedded_pairing_bls12_381_fq12_t* result, embedded_pairing_bls12_381_affine_pair_t* affine_pairs, size_t num_affine_pairs, embedded_pairing_bls12_381_prepared_pair_t* prepared_pairs, size_t num_prepared_pairs, size_t num_tasks, embedded_pairing_bls12_381_parallel_for_t parallel_for, void* executor);
+bool embedded_pairing_bls12_381_pairing_check(embedded_pairing_bls12_381_affine_pair_t* affine_pairs, size_t num_affine_pairs, embedded_pairing_bls12_381_prepared_pair_t* prepared_pairs, size_t num_prepared_pairs);
 
 extern const size_t embedded_pairing_bls12_381_g1_marshalled_compressed_size;
 extern const size_t embedded_pairing_bls12_381_g1_marshalled_uncompressed_size;
 extern const size_t embedded_pairing_bls12_381_g2_marshalled_compressed_size;
 extern const size_t embedded_pairing_bls12_381_g2_marshalled_uncompressed_size;
 extern const size_t embedded_pairing_bls12_381_gt_marshalled_size;
+extern const size_t embedded_pairing_bls12_381_gt_marshalled_compressed_size;
 
 void embedded_pairing_bls12_381_g1_marshal(void* buffer, const embedded_pairing_bls12_381_g1affine_t* a, bool compressed);
 bool embedded_pairing_bls12_381_g1_unmarshal(embedded_pairing_bls12_381_g1affine_t* a, const void* buffer, bool compressed, bool checked);
@@ -181,6 +187,10 @@ bool embedded_pairing_bls12_381_g2_unmarshal(embedded_pairing_bls12_381_g2affine
 void embedded_pairing_bls12_381_gt_marshal(void* buffer, const embedded_pairing_bls12_381_fq12_t* a);
 void embedded_pairing_bls12_381_gt_unmarshal(embedded_pairing_bls12_381_fq12_t* a, const void* buffer);
 
+/* Compressed (torus) encoding, valid only for elements of GT. */
+void embedded_pairing_bls12_381_gt_marshal_compressed(void* buffer, const embedded_pairing_bls12_381_fq12_t* a);
+bool embedded_pairing_bls12_381_gt_unmarshal_compressed(embedded_pairing_bls12_381_fq12_t* a, const void* buffer, bool checked);
+
 #ifdef __cplusplus
 }
 #endif
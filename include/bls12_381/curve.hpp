@@ -107,12 +107,22 @@ namespace embedded_pairing::bls12_381 {
             x3b.square(x);
             x3b.multiply(x3b, x);
             x3b.add(x3b, curve_b);
-            if (checked && x3b.legendre() == -1) {
-                return false;
+
+            /*
+             * Computing the square root and checking it is cheaper than
+             * computing the Legendre symbol before the square root.
+             */
+            BaseField root;
+            if (checked) {
+                if (!root.checked_square_root(x3b)) {
+                    return false;
+                }
+            } else {
+                root.square_root(x3b);
             }
 
             this->x.copy(x);
-            this->y.square_root(x3b);
+            this->y.copy(root);
 
             BaseField negy;
             negy.negate(y);
@@ -209,6 +219,57 @@ namespace embedded_pairing::bls12_381 {
 
             this->infinity = false;
         }
+
+        /* Bounds the stack space used by batch_from_projective. */
+#if defined(__ARM_ARCH_6M__)
+        static constexpr size_t batch_chunk_size = 4;
+#else
+        static constexpr size_t batch_chunk_size = 64;
+#endif
+
+        /*
+         * Converts the N points in IN to affine coordinates, writing the
+         * results to OUT. The z coordinates are inverted together with
+         * core::batch_inverse, so this costs one inversion per
+         * batch_chunk_size points instead of one per point. IN and OUT must
+         * not overlap.
+         *
+         * This is a template so that arrays of subclasses (e.g., G1Affine and
+         * G1) are indexed correctly.
+         */
+        template <typename AffineType, typename ProjectiveType>
+        static void batch_from_projective(AffineType* __restrict out, const ProjectiveType* __restrict in, size_t n) {
+            BaseField z[batch_chunk_size];
+            BaseField zinv[batch_chunk_size];
+
+            for (size_t start = 0; start < n; start += batch_chunk_size) {
+                size_t count = (n - start < batch_chunk_size) ? n - start : batch_chunk_size;
+                for (size_t i = 0; i != count; i++) {
+                    z[i].copy(in[start + i].z);
+                }
+
+                /* Points at infinity have z = 0, which maps to zero. */
+                core::batch_inverse(zinv, z, count);
+
+                for (size_t i = 0; i != count; i++) {
+                    const ProjectiveType& a = in[start + i];
+                    AffineType& res = out[start + i];
+                    if (a.is_zero()) {
+                        res.copy(zero);
+                        continue;
+                    }
+
+                    BaseField zinvpow;
+                    zinvpow.square(zinv[i]);
+                    res.x.multiply(a.x, zinvpow);
+
+                    zinvpow.multiply(zinvpow, zinv[i]);
+                    res.y.multiply(a.y, zinvpow);
+
+                    res.infinity = false;
+                }
+            }
+        }
     };
 
     template <typename BaseField, typename ScalarField, const BaseField& curve_b>
@@ -424,6 +485,15 @@ namespace embedded_pairing::bls12_381 {
 
         template <typename ScalarField, const BaseField& coeff_b>
         void add(const Projective<BaseField>& a, const Affine<BaseField, ScalarField, coeff_b>& __restrict b) {
+            this->add_mixed(a, b);
+        }
+
+        /*
+         * Mixed addition: B must be either an affine point or a projective
+         * point that is normalized (z = 1, or the point at infinity).
+         */
+        template <typename Point>
+        void add_mixed(const Projective<BaseField>& a, const Point& __restrict b) {
             if (b.is_zero()) {
                 this->copy(a);
                 return;
@@ -492,6 +562,41 @@ namespace embedded_pairing::bls12_381 {
             this->z.subtract(this->z, hh);
         }
 
+        /*
+         * Scales each of the N points so that z = 1, except for points at
+         * infinity, using one inversion in total. The results can be added
+         * with add_mixed. SCRATCH must have room for 2N elements.
+         *
+         * This is a template so that arrays of subclasses (e.g., G1) are
+         * indexed correctly.
+         */
+        template <typename ProjectiveType>
+        static void batch_normalize(ProjectiveType* points, BaseField* scratch, size_t n) {
+            BaseField* z = scratch;
+            BaseField* zinv = &scratch[n];
+            for (size_t i = 0; i != n; i++) {
+                z[i].copy(points[i].z);
+            }
+
+            /* Points at infinity have z = 0, which maps to zero. */
+            core::batch_inverse(zinv, z, n);
+
+            for (size_t i = 0; i != n; i++) {
+                if (points[i].is_zero()) {
+                    continue;
+                }
+
+                BaseField zinvpow;
+                zinvpow.square(zinv[i]);
+                points[i].x.multiply(points[i].x, zinvpow);
+
+                zinvpow.multiply(zinvpow, zinv[i]);
+                points[i].y.multiply(points[i].y, zinvpow);
+
+                points[i].z.copy(BaseField::one);
+            }
+        }
+
         void negate(const Projective<BaseField>& a) {
             this->x.copy(a.x);
             this->y.negate(a.y);
@@ -603,6 +708,7 @@ namespace embedded_pairing::bls12_381 {
         static const G1 one;
 
         void endomorphism(const G1& a);
+        static void decompose_endomorphism(BigInt<256>& c0, bool& c0_neg, BigInt<256>& c1, bool& c1_neg, const BigInt<256>& scalar);
         void multiply_endomorphism(const G1& base, const BigInt<256>& c0, bool c0_neg, const BigInt<256>& c1, bool c1_neg);
         void multiply_endomorphism(const G1& base, const BigInt<256>& scalar);
 
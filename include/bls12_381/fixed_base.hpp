@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EMBEDDED_PAIRING_BLS12_381_FIXED_BASE_HPP_
+#define EMBEDDED_PAIRING_BLS12_381_FIXED_BASE_HPP_
+
+#include <stddef.h>
+#include "core/bigint.hpp"
+#include "bls12_381/curve.hpp"
+#include "bls12_381/fq12.hpp"
+#include "bls12_381/pairing.hpp"
+#include "bls12_381/decomposition.hpp"
+
+namespace embedded_pairing::bls12_381 {
+    /*
+     * Precomputed table for raising a fixed element of GT to many different
+     * exponents, using the comb method of Lim and Lee ("More Flexible
+     * Exponentiation with Precomputation", CRYPTO 1994).
+     *
+     * The exponent is taken in its PowersOfX form (c0, c1, c2, c3), which
+     * we treat as a 256-bit string whose bit 64 * j + i stands for the base
+     * a^(|x|^j * 2^i). That string is cut into TEETH rows, and each row
+     * into BLOCKS blocks; the table has, for each block, the product of
+     * every nonempty subset of the bases at the first bit of that block in
+     * each row. Exponentiating then takes 256 / (TEETH * BLOCKS) - 1
+     * squarings and, at most, 256 / TEETH multiplications.
+     *
+     * The default, <4, 64>, needs no squarings and at most 64
+     * multiplications, but the table has 960 elements of GT (about 540
+     * KiB). Memory-constrained users should choose fewer blocks, which
+     * shrinks the table proportionally at the cost of more squarings
+     * (e.g., <4, 8> takes 7 squarings and about 68 KiB).
+     */
+    template <unsigned int teeth = 4, unsigned int blocks = 64>
+    struct GTFixedBaseTable {
+        static constexpr unsigned int exponent_bits = 256;
+        static constexpr unsigned int row_bits = exponent_bits / teeth;
+        static constexpr unsigned int block_bits = row_bits / blocks;
+        static constexpr unsigned int entries_per_block = (1 << teeth) - 1;
+
+        static_assert(teeth >= 1 && teeth <= 16 && exponent_bits % teeth == 0, "teeth must divide 256");
+        static_assert(blocks >= 1 && row_bits % blocks == 0, "blocks must divide 256 / teeth");
+
+        /* table[k][u - 1] corresponds to the subset of rows given by u. */
+        Fq12 table[blocks][entries_per_block];
+
+        void fill_table(const Fq12& a) {
+            /* First, the single-row entries, in increasing order of i. */
+            Fq12 power;
+            power.copy(a);
+            for (unsigned int i = 0; i != 64; i++) {
+                if (i != 0) {
+                    power.square_cyclotomic(power);
+                }
+                for (unsigned int t = 0; t != teeth; t++) {
+                    for (unsigned int k = 0; k != blocks; k++) {
+                        unsigned int p = t * row_bits + k * block_bits;
+                        if ((p & 0x3F) == i) {
+                            unsigned int j = p >> 6;
+                            Fq12& entry = this->table[k][(1 << t) - 1];
+                            entry.frobenius_map(power, j);
+                            if (((j & 0x1) == 0) != bls_x_is_negative) {
+                                entry.conjugate(entry);
+                            }
+                        }
+                    }
+                }
+            }
+
+            /* Then, the products of multiple rows. */
+            for (unsigned int k = 0; k != blocks; k++) {
+                for (unsigned int u = 1; u != (1 << teeth); u++) {
+                    unsigned int rest = u & (u - 1);
+                    if (rest != 0) {
+                        this->table[k][u - 1].multiply(this->table[k][rest - 1], this->table[k][(u ^ rest) - 1]);
+                    }
+                }
+            }
+        }
+
+        /* Sets result to a^(c0 + c1*|x| + c2*|x|^2 + c3*|x|^3). */
+        void exponentiate(Fq12& result, const PowersOfX& scalar) const {
+            bool found_one = false;
+            for (int s = block_bits - 1; s != -1; s--) {
+                if (found_one) {
+                    result.square_cyclotomic(result);
+                }
+                for (unsigned int k = 0; k != blocks; k++) {
+                    unsigned int u = 0;
+                    for (unsigned int t = 0; t != teeth; t++) {
+                        unsigned int p = t * row_bits + k * block_bits + s;
+                        u |= ((unsigned int) scalar.c[p >> 6].bit(p & 0x3F)) << t;
+                    }
+                    if (u != 0) {
+                        if (found_one) {
+                            result.multiply(result, this->table[k][u - 1]);
+                        } else {
+                            result.copy(this->table[k][u - 1]);
+                            found_one = true;
+                        }
+                    }
+                }
+            }
+            if (!found_one) {
+                result.copy(Fq12::one);
+            }
+        }
+
+        void exponentiate(Fq12& result, const BigInt<256>& scalar) const {
+            PowersOfX decomposed;
+            decomposed.decompose(scalar);
+            this->exponentiate(result, decomposed);
+        }
+
+        /*
+         * Chooses an exponent y uniformly distributed in [0, r) and sets
+         * result to a^y, like Fq12::random_gt.
+         */
+        void random_gt(Fq12& result, BigInt<256>& y, void (*get_random_bytes)(void*, size_t)) const {
+            PowersOfX scalar;
+            scalar.random(y, get_random_bytes);
+            this->exponentiate(result, scalar);
+        }
+    };
+
+    template <typename Projective>
+    struct FixedBaseAffine;
+
+    template <>
+    struct FixedBaseAffine<G1> {
+        typedef G1Affine type;
+    };
+
+    template <>
+    struct FixedBaseAffine<G2> {
+        typedef G2Affine type;
+    };
+
+    /*
+     * Precomputed table for multiplying a fixed point of G1 or G2 by many
+     * different scalars, using the same comb method as GTFixedBaseTable,
+     * directly on the 256-bit scalar. The table entries are affine, so that
+     * the additions are mixed additions. Multiplying takes
+     * 256 / (TEETH * BLOCKS) - 1 doublings and, at most, 256 / TEETH
+     * additions.
+     *
+     * Unlike in GT, doublings are cheap next to additions, so the default
+     * uses more teeth: <8, 4> takes 7 doublings and at most 32 additions,
+     * with a table of 1020 affine points (about 100 KiB for G1 and 200 KiB
+     * for G2). Memory-constrained users should choose fewer blocks or teeth
+     * (e.g., <8, 1> takes 31 doublings and about 25 KiB for G1). Filling the
+     * table uses stack space for BLOCKS projective points, plus one chunk of
+     * AffineType::batch_chunk_size projective points.
+     */
+    template <typename Projective, unsigned int teeth = 8, unsigned int blocks = 4>
+    struct FixedBaseTable {
+        typedef typename FixedBaseAffine<Projective>::type AffineType;
+
+        static constexpr unsigned int scalar_bits = 256;
+        static constexpr unsigned int row_bits = scalar_bits / teeth;
+        static constexpr unsigned int block_bits = row_bits / blocks;
+        static constexpr unsigned int entries_per_block = (1u << teeth) - 1;
+
+        static_assert(teeth >= 1 && teeth <= 16 && scalar_bits % teeth == 0, "teeth must divide 256");
+        static_assert(blocks >= 1 && row_bits % blocks == 0, "blocks must divide 256 / teeth");
+
+        /*
+         * table[k][u - 1] is the sum, over each row t in the subset u, of
+         * 2^(t * row_bits + k * block_bits) times the base.
+         */
+        AffineType table[blocks][entries_per_block];
+
+        void fill_table(const Projective& a) {
+            /* First, the single-row entries, one row at a time. */
+            Projective power;
+            power.copy(a);
+            for (unsigned int t = 0; t != teeth; t++) {
+                Projective row[blocks];
+                AffineType row_affine[blocks];
+                for (unsigned int k = 0; k != blocks; k++) {
+                    if (t != 0 || k != 0) {
+                        for (unsigned int i = 0; i != block_bits; i++) {
+                            power.multiply2(power);
+                        }
+                    }
+                    row[k].copy(power);
+                }
+                AffineType::batch_from_projective(row_affine, row, blocks);
+                for (unsigned int k = 0; k != blocks; k++) {
+                    this->table[k][(1u << t) - 1].copy(row_affine[k]);
+                }
+            }
+
+            /*
+             * Then, the sums of multiple rows. The entries whose highest row
+             * is t are contiguous, and are the entries with lower rows plus
+             * the single-row entry for t, so we fill them in one row at a
+             * time, converting them to affine together, a chunk at a time.
+             */
+            constexpr unsigned int chunk_size = AffineType::batch_chunk_size;
+            Projective sums[chunk_size];
+            for (unsigned int k = 0; k != blocks; k++) {
+                for (unsigned int t = 1; t != teeth; t++) {
+                    unsigned int single = (1u << t) - 1;
+                    for (unsigned int start = 0; start < single; start += chunk_size) {
+                        unsigned int count = (single - start < chunk_size) ? single - start : chunk_size;
+                        for (unsigned int i = 0; i != count; i++) {
+                            sums[i].from_affine(this->table[k][start + i]);
+                            sums[i].add(sums[i], this->table[k][single]);
+                        }
+                        AffineType::batch_from_projective(&this->table[k][single + 1 + start], sums, count);
+                    }
+                }
+            }
+        }
+
+        void fill_table(const AffineType& a) {
+            Projective projective;
+            projective.from_affine(a);
+            this->fill_table(projective);
+        }
+
+        /* Sets result to scalar times the base. */
+        void multiply(Projective& result, const BigInt<256>& scalar) const {
+            bool found_one = false;
+            for (int s = block_bits - 1; s != -1; s--) {
+                if (found_one) {
+                    result.multiply2(result);
+                }
+                for (unsigned int k = 0; k != blocks; k++) {
+                    unsigned int u = 0;
+                    for (unsigned int t = 0; t != teeth; t++) {
+                        u |= ((unsigned int) scalar.bit(t * row_bits + k * block_bits + s)) << t;
+                    }
+                    if (u != 0) {
+                        if (found_one) {
+                            result.add(result, this->table[k][u - 1]);
+                        } else {
+                            result.from_affine(this->table[k][u - 1]);
+                            found_one = true;
+                        }
+                    }
+                }
+            }
+            if (!found_one) {
+                result.copy(Projective::zero);
+            }
+        }
+    };
+}
+
+#endif
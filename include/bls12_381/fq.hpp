@@ -37,9 +37,12 @@
 #include "core/bigint.hpp"
 #include "core/fp.hpp"
 #include "core/fp_utils.hpp"
+#include "core/fp_batch.hpp"
 
 using embedded_pairing::core::BigInt;
 using embedded_pairing::core::Fp;
+using embedded_pairing::core::FpDouble;
+using embedded_pairing::core::FpBatch;
 
 namespace embedded_pairing::bls12_381 {
     static constexpr int fq_bits = 384;
@@ -72,13 +75,21 @@ namespace embedded_pairing::bls12_381 {
         inline void inverse(const Fq& a) {
             fp_inverse(*this, a);
         }
+        int legendre(void) const;
         void square_root(const Fq& a);
+        bool checked_square_root(const Fq& a);
         void random(void (*get_random_bytes)(void*, size_t));
         bool hash_reduce(void);
         void write_big_endian(uint8_t* buffer) const;
         void read_big_endian(const uint8_t* buffer);
     };
 
+    /* Unreduced product of two elements of Fq (see FpDoubleBase). */
+    typedef FpDouble<fq_bits, fq_modulus_var> FqDouble;
+
+    /* Batch of elements of Fq, processed in parallel (see FpBatchBase). */
+    typedef FpBatch<Fq> FqBatch;
+
     constexpr Fq Fq::zero = {{{.val = {0}}}};
     constexpr Fq Fq::one = {{{.val = fq_R }}};
     constexpr Fq Fq::negative_one = {{{.val = {.std_words = {0xfffcaaae, 0x43f5ffff, 0xed47fffd, 0x32b7fff2, 0xa2e99d69, 0x7e83a49, 0x8332bb7a, 0xeca8f331, 0xa0f4c069, 0xef148d1e, 0x3eff0206, 0x40ab326}}}}};
@@ -58,6 +58,13 @@ namespace embedded_pairing::bls12_381 {
         void multiply(const Fq12& a, const Fq12& b);
         void square(const Fq12& a);
         void multiply_by_c014(const Fq12& a, const Fq2& __restrict c0, const Fq2& __restrict c1, const Fq2& __restrict c4);
+
+        /*
+         * Sets this to the product of two sparse elements, each of the form
+         * multiplied in by multiply_by_c014. This is cheaper than multiplying
+         * both into a dense element one at a time.
+         */
+        void multiply_c014_by_c014(const Fq2& __restrict a0, const Fq2& __restrict a1, const Fq2& __restrict a4, const Fq2& __restrict b0, const Fq2& __restrict b1, const Fq2& __restrict b4);
         void conjugate(const Fq12& a);
         void random(void (*get_random_bytes)(void*, size_t));
         void write_big_endian(uint8_t* buffer) const;
@@ -69,6 +76,12 @@ namespace embedded_pairing::bls12_381 {
          */
         void square_cyclotomic(const Fq12& a);
 
+        /*
+         * Sets this to a^(2^n) by squaring N times. Long runs of squarings
+         * use Karabina's compressed squaring (see Fq12Compressed).
+         */
+        void square_cyclotomic_repeated(const Fq12& a, unsigned int n);
+
         template <typename BigInt>
         void exponentiate_restrict_cyclotomic_nodiv(const Fq12& __restrict a, const BigInt& __restrict power) {
 #ifdef RESIST_SIDE_CHANNELS
@@ -154,6 +167,35 @@ namespace embedded_pairing::bls12_381 {
 
     constexpr Fq12 Fq12::one = {.c0 = Fq6::one, .c1 = Fq6::zero};
     constexpr Fq12 Fq12::zero = {.c0 = Fq6::zero, .c1 = Fq6::zero};
+
+    /*
+     * An element of the cyclotomic subgroup in Karabina's compressed form
+     * ("Squaring in cyclotomic subgroups", Math. Comp. 82, 2013). Of the six
+     * Fq2 coefficients, only four are kept, named g2 to g5 as in RELIC; the
+     * other two, g0 = c0.c0 and g1 = c1.c1, are recovered when
+     * decompressing. This is enough to compute squares (with six Fq2
+     * squarings, as opposed to nine for square_cyclotomic), but going back
+     * to the usual form needs an inversion. So this is useful for long runs
+     * of squarings, especially if several results can be decompressed
+     * together.
+     */
+    struct Fq12Compressed {
+        Fq2 g2; /* c1.c0 */
+        Fq2 g3; /* c0.c2 */
+        Fq2 g4; /* c0.c1 */
+        Fq2 g5; /* c1.c2 */
+
+        void compress(const Fq12& a);
+        void square(const Fq12Compressed& a);
+        void decompress(Fq12& result) const;
+
+        /*
+         * Decompresses the N elements of A into RESULT, sharing a single
+         * inversion among each group of up to 16 of them (2 on embedded
+         * platforms).
+         */
+        static void batch_decompress(Fq12* __restrict result, const Fq12Compressed* __restrict a, size_t n);
+    };
 }
 
 #endif
@@ -38,6 +38,8 @@
 #include "./fq.hpp"
 
 namespace embedded_pairing::bls12_381 {
+    struct Fq2Double;
+
     struct Fq2 {
         Fq c0;
         Fq c1;
@@ -57,9 +59,11 @@ namespace embedded_pairing::bls12_381 {
         void multiply(const Fq2& a, const Fq2& b);
         void square(const Fq2& a);
         void multiply_by_nonresidue(const Fq2& a);
+        void montgomery_reduce(Fq2Double& __restrict a);
         void norm(Fq& __restrict result) const;
         int legendre(void) const;
         void square_root(const Fq2& __restrict a);
+        bool checked_square_root(const Fq2& a);
         void random(void (*get_random_bytes)(void*, size_t));
         bool hash_reduce(void);
         void write_big_endian(uint8_t* buffer) const;
@@ -69,6 +73,21 @@ namespace embedded_pairing::bls12_381 {
         static int compare(const Fq2& a, const Fq2& b);
     };
 
+    /*
+     * Unreduced counterpart of Fq2. Sums of products in the extension tower
+     * are accumulated in this type, so that each output coefficient needs
+     * only one Montgomery reduction.
+     */
+    struct Fq2Double {
+        FqDouble c0;
+        FqDouble c1;
+
+        void add(const Fq2Double& a, const Fq2Double& __restrict b);
+        void subtract(const Fq2Double& a, const Fq2Double& __restrict b);
+        void multiply(const Fq2& a, const Fq2& b);
+        void multiply_by_nonresidue(const Fq2Double& a);
+    };
+
     constexpr Fq2 Fq2::one = {.c0 = Fq::one, .c1 = Fq::zero};
     constexpr Fq2 Fq2::zero = {.c0 = Fq::zero, .c1 = Fq::zero};
     constexpr Fq2 Fq2::negative_one = {.c0 = Fq::negative_one, .c1 = Fq::zero};
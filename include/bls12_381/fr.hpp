@@ -37,6 +37,7 @@
 
 #include "core/bigint.hpp"
 #include "core/fp.hpp"
+#include "core/fp_utils.hpp"
 
 using embedded_pairing::core::BigInt;
 using embedded_pairing::core::Fp;
@@ -57,6 +58,9 @@ namespace embedded_pairing::bls12_381 {
         static const Fr zero;
         static const Fr one;
 
+        inline void inverse(const Fr& a) {
+            fp_inverse(*this, a);
+        }
         void square_root(const Fr& __restrict a);
         void random(void (*get_random_bytes)(void*, size_t));
         bool hash_reduce(void);
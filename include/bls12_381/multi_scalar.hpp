@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBEDDED_PAIRING_BLS12_381_MULTI_SCALAR_HPP_
+#define EMBEDDED_PAIRING_BLS12_381_MULTI_SCALAR_HPP_
+
+#include <stddef.h>
+#include "core/bigint.hpp"
+#include "bls12_381/curve.hpp"
+
+namespace embedded_pairing::bls12_381 {
+    /*
+     * Sets result to the sum of scalars[i] times bases[i], for i < N. This is
+     * much faster than multiplying each base separately and adding up the
+     * results. For small N, it uses Straus's method (interleaving the
+     * multiplications so that they share doublings); for larger N, it uses
+     * the bucket method of Pippenger, choosing the window size based on N.
+     * Both use signed digits, and neither needs memory proportional to N.
+     */
+    void multi_scalar_multiply(G1& result, const G1Affine* bases, const BigInt<256>* scalars, size_t n);
+    void multi_scalar_multiply(G1& result, const G1* bases, const BigInt<256>* scalars, size_t n);
+    void multi_scalar_multiply(G2& result, const G2Affine* bases, const BigInt<256>* scalars, size_t n);
+    void multi_scalar_multiply(G2& result, const G2* bases, const BigInt<256>* scalars, size_t n);
+}
+
+#endif
@@ -99,19 +99,111 @@ namespace embedded_pairing::bls12_381 {
         size_t coeff_idx;
     };
 
+    /*
+     * Many prepared pairs, for pairing products that reuse the same G2
+     * points, such as verification with many long-lived keys. The
+     * coefficients are stored iteration-major, so the k-th coefficients of
+     * all of the G2 points are contiguous, and a Miller loop over the batch
+     * reads them sequentially rather than striding across many 20 KiB
+     * G2Prepared structures. As in wkdibe::Params, the caller provides the
+     * storage: COEFFS must have room for num_coeffs * NUM_PAIRS triples, and
+     * G1 and INFINITY must each have NUM_PAIRS elements.
+     */
+    struct PreparedBatch {
+        static constexpr unsigned int num_coeffs = G2Prepared::num_coeffs;
+
+        const G1Affine* g1;
+        MillerTriple* coeffs;
+        bool* infinity;
+        size_t num_pairs;
+
+        /* Prepares G2 as the I-th G2 point of the batch. */
+        void prepare(size_t i, const G2Affine& g2);
+
+        /* Sets the I-th G2 point of the batch from an existing G2Prepared. */
+        void set(size_t i, const G2Prepared& g2);
+    };
+
+    void miller_loop(Fq12& result, const PreparedBatch& batch);
+
+    /*
+     * An executor for miller_loop_parallel. It must call TASK(ARG, i) once
+     * for each i < COUNT, possibly concurrently, and return once all of the
+     * calls have completed. This library has no notion of threads, so the
+     * caller supplies this (for example, backed by a thread pool); EXECUTOR
+     * is passed through unchanged.
+     */
+    typedef void (*ParallelFor)(void* executor, void (*task)(void*, size_t), void* arg, size_t count);
+
+    /*
+     * Upper bound on the number of tasks that miller_loop_parallel uses.
+     * miller_loop_parallel keeps one partial Fq12 per task on the stack, so
+     * it always uses miller_loop_max_tasks * sizeof(Fq12) bytes of stack
+     * (18 KiB, or 2 KiB on embedded platforms), whatever NUM_TASKS is.
+     */
+#if defined(__ARM_ARCH_6M__)
+    constexpr size_t miller_loop_max_tasks = 4;
+#else
+    constexpr size_t miller_loop_max_tasks = 32;
+#endif
+
+    /*
+     * Same as the multi-pair miller_loop, but splits the pairs into up to
+     * NUM_TASKS groups, computes a partial Miller loop for each group using
+     * PARALLEL_FOR, and multiplies the partial results. Different tasks
+     * never touch the same pair, so the pairs can be processed concurrently.
+     */
+    void miller_loop_parallel(Fq12& result, AffinePair* affine_pairs, size_t num_affine_pairs, PreparedPair* prepared_pairs, size_t num_prepared_pairs, size_t num_tasks, ParallelFor parallel_for, void* executor);
+
     void final_exponentiation(Fq12& result, const Fq12& a);
 
+    /*
+     * Sets result[i] to final_exponentiation(a[i]) for each i < n. This is
+     * faster than doing them one by one, because the inversions are shared
+     * across the batch. RESULT may be the same array as A.
+     */
+    void final_exponentiation_batch(Fq12* result, const Fq12* a, size_t n);
+
     inline void pairing_product(Fq12& result, AffinePair* affine_pairs, size_t num_affine_pairs, PreparedPair* prepared_pairs, size_t num_prepared_pairs) {
         miller_loop(result, affine_pairs, num_affine_pairs, prepared_pairs, num_prepared_pairs);
         final_exponentiation(result, result);
     }
 
+    inline void pairing_product_parallel(Fq12& result, AffinePair* affine_pairs, size_t num_affine_pairs, PreparedPair* prepared_pairs, size_t num_prepared_pairs, size_t num_tasks, ParallelFor parallel_for, void* executor) {
+        miller_loop_parallel(result, affine_pairs, num_affine_pairs, prepared_pairs, num_prepared_pairs, num_tasks, parallel_for, executor);
+        final_exponentiation(result, result);
+    }
+
+    inline void pairing_product(Fq12& result, const PreparedBatch& batch) {
+        miller_loop(result, batch);
+        final_exponentiation(result, result);
+    }
+
+    /*
+     * Returns true if and only if the product of the pairings of the given
+     * pairs is one. This is slightly cheaper than computing the product with
+     * pairing_product and comparing it to one, and it skips the final
+     * exponentiation when the answer is clear early. To check an equation of
+     * pairings, move everything to one side and use this function.
+     */
+    bool pairing_check(AffinePair* affine_pairs, size_t num_affine_pairs, PreparedPair* prepared_pairs, size_t num_prepared_pairs);
+    bool pairing_check(const PreparedBatch& batch);
+
     template <typename G2Type>
     void pairing(Fq12& result, const G1Affine& g1, const G2Type& g2) {
         miller_loop(result, g1, g2);
         final_exponentiation(result, result);
     }
 
+    /* Sets result[i] to the pairing of g1[i] and g2[i] for each i < n. */
+    template <typename G2Type>
+    void pairing_batch(Fq12* result, const G1Affine* g1, const G2Type* g2, size_t n) {
+        for (size_t i = 0; i != n; i++) {
+            miller_loop(result[i], g1[i], g2[i]);
+        }
+        final_exponentiation_batch(result, result, n);
+    }
+
     /* Pairing of G1Affine::generator and G2Affine::generator. */
     static constexpr Fq12 generator_pairing = {
         .c0 = {
@@ -167,6 +259,36 @@ namespace embedded_pairing::bls12_381 {
             }
         }
     };
+
+    /*
+     * Encoding of elements of GT in raw bytes. The uncompressed encoding is
+     * the 576-byte output of Fq12::write_big_endian, which can represent any
+     * element of Fq12. The compressed encoding (288 bytes) represents g in
+     * GT as the element c = (1 + g.c0) / g.c1 of Fq6, from which g is
+     * recovered as (c + w) / (c - w); this is the torus T2 representation of
+     * Rubin and Silverberg ("Torus-Based Cryptography", CRYPTO 2003). The
+     * identity, for which g.c1 = 0, is encoded as c = 0. The compressed
+     * encoding only works for elements of the cyclotomic subgroup, so it
+     * must not be used for arbitrary elements of Fq12.
+     */
+    template <bool compressed>
+    struct Encoding<Fq12, compressed> {
+        static constexpr size_t size = compressed ? sizeof(Fq6) : sizeof(Fq12);
+        uint8_t data[size];
+
+        void encode(const Fq12& g);
+
+        /*
+         * If CHECKED is true, a compressed encoding is accepted only if it
+         * decodes to an element of GT. The uncompressed encoding is never
+         * checked, since it can hold any element of Fq12.
+         */
+        bool decode(Fq12& g, bool checked) const;
+    };
+
+    /* Encoding struct is explicitly instantiated in gt_encoding.cpp. */
+    typedef Encoding<Fq12, false> GTUncompressed;
+    typedef Encoding<Fq12, true> GTCompressed;
 }
 
 #endif
@@ -36,8 +36,21 @@
 #include <stdint.h>
 
 namespace embedded_pairing::bls12_381 {
-    template <typename Projective, unsigned int window>
+    /*
+     * Whether WnafTable normalizes its entries by default. Normalizing costs
+     * one inversion for the whole table plus a few multiplications per
+     * entry, but makes each addition of a table entry a mixed addition,
+     * which is about a quarter cheaper than a projective addition. For
+     * larger windows, the table grows while the number of additions
+     * shrinks, and normalizing stops paying for itself.
+     */
+    constexpr bool wnaf_table_normalized_default(unsigned int window) {
+        return window <= 4;
+    }
+
+    template <typename Projective, unsigned int window, bool normalized = wnaf_table_normalized_default(window)>
     struct WnafTable {
+        typedef typename Projective::BaseFieldType BaseField;
         static constexpr int table_size = 1 << (window - 1);
         Projective table[table_size];
 
@@ -50,51 +63,178 @@ namespace embedded_pairing::bls12_381 {
             for (int i = 1; i != table_size; i++) {
                 table[i].add(table[i - 1], two_base);
             }
+
+            if constexpr(normalized) {
+                BaseField scratch[2 * table_size];
+                Projective::batch_normalize(table, scratch, table_size);
+            }
+        }
+
+        /*
+         * Sets result = result + entry, where ENTRY is an element of the table
+         * (or its negation, or its image under an endomorphism that keeps
+         * z = 1, like G1::endomorphism or G2::frobenius_map).
+         */
+        static void add_entry(Projective& result, const Projective& entry) {
+            if constexpr(normalized) {
+                result.add_mixed(result, entry);
+            } else {
+                result.add(result, entry);
+            }
         }
     };
 
-    /* This probably doesn't work for window >= 8 */
+    /*
+     * Digits are odd and less than 2^window in absolute value, so they fit
+     * in an int8_t for window <= 7. Larger windows use 16-bit digits.
+     */
+    template <bool wide>
+    struct WnafDigit;
+
+    template <>
+    struct WnafDigit<false> {
+        typedef int8_t type;
+    };
+
+    template <>
+    struct WnafDigit<true> {
+        typedef int16_t type;
+    };
+
+    /*
+     * Returns COUNT bits of A, starting at POSITION, as an integer. Bits at
+     * negative positions, or at positions past the end of A, are zero.
+     */
+    template <int bits>
+    unsigned int wnaf_read_bits(const BigInt<bits>& a, int position, unsigned int count) {
+        unsigned int result = 0;
+        for (unsigned int i = 0; i != count; i++) {
+            int p = position + (int) i;
+            if (p >= 0 && p < bits && a.bit(p)) {
+                result |= 1u << i;
+            }
+        }
+        return result;
+    }
+
     template <int bits, unsigned int window>
     struct WnafScalar {
-        int8_t wnaf[bits + 1];
+        static_assert(window >= 1 && window <= 15, "unsupported window size");
+        typedef typename WnafDigit<(window > 7)>::type Digit;
+
+        Digit wnaf[bits + 1];
         int wnaf_size;
 
         void from_bigint(const BigInt<bits>& scalar) {
-            BigInt<bits> c;
-            BigInt<bits> a;
-            c.copy(scalar);
-            a.clear();
-
+            /*
+             * Instead of subtracting each digit from the scalar, we keep
+             * track of the carry that subtracting a negative digit would
+             * propagate upward, and read the scalar's bits directly.
+             */
+            unsigned int carry = 0;
             int i = 0;
-            int16_t u;
-            while (!c.is_zero()) {
-                if (c.is_odd()) {
-                    u = (int16_t) (c.bytes[0] & ((1 << (window + 1)) - 1));
-
-                    if (u > (1 << window)) {
-                        u -= (1 << (window + 1));
-                    }
-
-                    if (u > 0) {
-                        a.bytes[0] = (uint8_t) u;
-                        c.subtract(c, a);
-                    } else {
-                        a.bytes[0] = (uint8_t) (-u);
-                        c.add(c, a);
-                    }
-                } else {
-                    u = 0;
+            wnaf_size = 0;
+            while (i < bits || carry != 0) {
+                if ((unsigned int) (i < bits && scalar.bit(i)) == carry) {
+                    wnaf[i++] = 0;
+                    continue;
                 }
 
-                wnaf[i++] = (int8_t) u;
-                c.template shift_right_in_word<1>(c);
+                int32_t u = (int32_t) (wnaf_read_bits(scalar, i, window + 1) + carry);
+                carry = (u >> window) & 0x1;
+                u -= (int32_t) carry << (window + 1);
+
+                wnaf[i] = (Digit) u;
+                wnaf_size = i + 1;
+                for (unsigned int j = 1; j <= window && i + (int) j <= bits; j++) {
+                    wnaf[i + j] = 0;
+                }
+                i += window + 1;
+            }
+        }
+    };
+
+    /*
+     * Produces the digits of a scalar most significant first, without
+     * storing them, so that it needs constant memory regardless of the
+     * number of digits. This can replace WnafScalar in wnaf_table_multiply.
+     *
+     * The digits are not exactly the w-NAF of the scalar (which can only be
+     * computed starting from the least significant digit), but its
+     * left-to-right analogue, the width-w mutual opposite form of Okeya et
+     * al. ("Signed Binary Representations Revisited", CRYPTO 2004). The
+     * digits come from the same set, and the same fraction of them are
+     * nonzero on average, so it is just as fast. The idea is that the scalar
+     * k equals 2k - k, so it can be written with digit k_(i-1) - k_i at each
+     * position i; we scan these from the top, and whenever we see a nonzero
+     * one, we combine it with the next WINDOW positions into a single odd
+     * digit at the lowest nonzero position among them.
+     */
+    template <int bits, unsigned int window>
+    struct WnafRecoder {
+        static_assert(window >= 1 && window <= 15, "unsupported window size");
+        typedef typename WnafDigit<(window > 7)>::type Digit;
+
+        BigInt<bits> scalar;
+        int position;
+        int digit_position;
+        Digit digit;
+
+        void from_bigint(const BigInt<bits>& a) {
+            this->scalar.copy(a);
+            this->position = bits;
+            this->digit_position = bits + 1;
+        }
+
+        bool done(void) const {
+            return this->position == -1;
+        }
+
+        /* Returns the digit at the current position, and moves down one. */
+        Digit next(void) {
+            int i = this->position--;
+            if (i > this->digit_position) {
+                return 0;
+            }
+            if (i == this->digit_position) {
+                return this->digit;
+            }
+            if (this->bit(i - 1) == this->bit(i)) {
+                return 0;
             }
-            wnaf_size = i;
+
+            int j = i - (int) window;
+            if (j < 0) {
+                j = 0;
+            }
+            while (this->bit(j - 1) == this->bit(j)) {
+                j++;
+            }
+
+            /*
+             * The digits from position i down to position j add up to
+             * k_(j-1) + (k_(i-1) ... k_j in binary) - k_i * 2^(i-j).
+             */
+            int32_t v = (int32_t) this->bit(j - 1) + (int32_t) wnaf_read_bits(this->scalar, j, i - j);
+            if (this->bit(i)) {
+                v -= ((int32_t) 1) << (i - j);
+            }
+
+            if (j == i) {
+                return (Digit) v;
+            }
+            this->digit_position = j;
+            this->digit = (Digit) v;
+            return 0;
+        }
+
+        bool bit(int i) const {
+            return i >= 0 && i < bits && this->scalar.bit(i);
         }
     };
 
-    template <typename Projective, int bits, unsigned int window>
-    void wnaf_table_multiply(Projective& result, const WnafTable<Projective, window>& table, const WnafScalar<bits, window>& power) {
+    template <typename Projective, int bits, unsigned int window, bool normalized>
+    void wnaf_table_multiply(Projective& result, const WnafTable<Projective, window, normalized>& table, const WnafScalar<bits, window>& power) {
         result.copy(Projective::zero);
 
         bool found_one = false;
@@ -106,11 +246,36 @@ namespace embedded_pairing::bls12_381 {
 
             if (power.wnaf[i] != 0) {
                 if (power.wnaf[i] > 0) {
-                    result.add(result, table.table[power.wnaf[i] >> 1]);
+                    table.add_entry(result, table.table[power.wnaf[i] >> 1]);
                 } else {
                     Projective tmp;
                     tmp.negate(table.table[(-power.wnaf[i]) >> 1]);
-                    result.add(result, tmp);
+                    table.add_entry(result, tmp);
+                }
+                found_one = true;
+            }
+        }
+    }
+
+    template <typename Projective, int bits, unsigned int window, bool normalized>
+    void wnaf_table_multiply(Projective& result, const WnafTable<Projective, window, normalized>& table, WnafRecoder<bits, window>& power) {
+        result.copy(Projective::zero);
+
+        bool found_one = false;
+
+        while (!power.done()) {
+            if (found_one) {
+                result.multiply2(result);
+            }
+
+            int32_t d = power.next();
+            if (d != 0) {
+                if (d > 0) {
+                    table.add_entry(result, table.table[d >> 1]);
+                } else {
+                    Projective tmp;
+                    tmp.negate(table.table[(-d) >> 1]);
+                    table.add_entry(result, tmp);
                 }
                 found_one = true;
             }
@@ -136,8 +301,8 @@ namespace embedded_pairing::bls12_381 {
         wnaf_table_multiply(result, t, power);
     }
 
-    template <typename Projective, typename Base, int bits, unsigned int window>
-    void wnaf_multiply(Projective& result, const WnafTable<Projective, window>& a, const BigInt<bits>& power) {
+    template <typename Projective, typename Base, int bits, unsigned int window, bool normalized>
+    void wnaf_multiply(Projective& result, const WnafTable<Projective, window, normalized>& a, const BigInt<bits>& power) {
         WnafScalar<bits, window> s;
         s.from_bigint(power);
 
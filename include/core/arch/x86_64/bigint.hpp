@@ -37,6 +37,9 @@ extern "C" {
     bool embedded_pairing_core_arch_x86_64_bigint_384_add(void* res, const void* a, const void* b);
     bool embedded_pairing_core_arch_x86_64_bigint_384_subtract(void* res, const void* a, const void* b);
     uint64_t embedded_pairing_core_arch_x86_64_bigint_384_multiply2(void* res, const void* a);
+    bool embedded_pairing_core_arch_x86_64_bigint_256_add(void* res, const void* a, const void* b);
+    bool embedded_pairing_core_arch_x86_64_bigint_256_subtract(void* res, const void* a, const void* b);
+    uint64_t embedded_pairing_core_arch_x86_64_bigint_256_multiply2(void* res, const void* a);
 
     void embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_multiply(void* res, const void* a, const void* b);
     void embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_square(void* res, const void* a);
@@ -62,6 +65,22 @@ namespace embedded_pairing::core {
         return embedded_pairing_core_arch_x86_64_bigint_384_multiply2(this, &a);
     }
 
+    template <>
+    inline bool BigInt<256>::add(const BigInt<256>& a, const BigInt<256>& __restrict b) {
+        return embedded_pairing_core_arch_x86_64_bigint_256_add(this, &a, &b);
+    }
+
+    template <>
+    inline bool BigInt<256>::subtract(const BigInt<256>& a, const BigInt<256>& __restrict b) {
+        return embedded_pairing_core_arch_x86_64_bigint_256_subtract(this, &a, &b);
+    }
+
+    template <>
+    template <>
+    inline typename BigInt<256>::word_t BigInt<256>::shift_left_in_word<1>(const BigInt<256>& a) {
+        return embedded_pairing_core_arch_x86_64_bigint_256_multiply2(this, &a);
+    }
+
     template <>
     template <>
     inline void BigInt<768>::multiply(const BigInt<384>& a, const BigInt<384>& __restrict b) {
@@ -36,14 +36,30 @@
 #define EMBEDDED_PAIRING_CORE_ARCH_X86_64_FP_HPP_
 
 extern "C" {
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
     void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_montgomery_reduce(void* res, void* a, const void* p, uint64_t inv_word);
     void embedded_pairing_core_arch_x86_64_fpbase_384_add(void* res, const void* a, const void* b, const void* p);
     void embedded_pairing_core_arch_x86_64_fpbase_384_subtract(void* res, const void* a, const void* b, const void* p);
     void embedded_pairing_core_arch_x86_64_fpbase_384_multiply2(void* res, const void* a, const void* p);
+    void embedded_pairing_core_arch_x86_64_fpdouble_384_add(void* res, const void* a, const void* b, const void* p);
+    void embedded_pairing_core_arch_x86_64_fpdouble_384_subtract(void* res, const void* a, const void* b, const void* p);
+
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square(void* res, const void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce(void* res, void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_fpbase_256_add(void* res, const void* a, const void* b, const void* p);
+    void embedded_pairing_core_arch_x86_64_fpbase_256_subtract(void* res, const void* a, const void* b, const void* p);
+    void embedded_pairing_core_arch_x86_64_fpbase_256_multiply2(void* res, const void* a, const void* p);
 }
 
 namespace embedded_pairing::core {
+    extern void (*runtime_fpbase_384_multiply)(void*, const void*, const void*, const void*, uint64_t);
+    extern void (*runtime_fpbase_384_square)(void*, const void*, const void*, uint64_t);
     extern void (*runtime_fpbase_384_montgomery_reduce)(void*, void*, const void*, uint64_t);
+    extern void (*runtime_fpbase_256_multiply)(void*, const void*, const void*, const void*, uint64_t);
+    extern void (*runtime_fpbase_256_square)(void*, const void*, const void*, uint64_t);
+    extern void (*runtime_fpbase_256_montgomery_reduce)(void*, void*, const void*, uint64_t);
 
     template <>
     inline void FpBase<384>::add(const FpBase<384>& a, const FpBase<384>& __restrict b, const BigInt<384>& __restrict p) {
@@ -60,12 +76,87 @@ namespace embedded_pairing::core {
         embedded_pairing_core_arch_x86_64_fpbase_384_multiply2(this, &a, &p);
     }
 
+    template <>
+    inline void FpBase<384>::multiply(const FpBase<384>& a, const FpBase<384>& b, const BigInt<384>& __restrict p, typename BigInt<384>::word_t inv_word) {
+#ifdef __BMI2__
+        embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply(this, &a, &b, &p, inv_word);
+#else
+        runtime_fpbase_384_multiply(this, &a, &b, &p, inv_word);
+#endif
+    }
+
+    template <>
+    inline void FpBase<384>::square(const FpBase<384>& a, const BigInt<384>& __restrict p, typename BigInt<384>::word_t inv_word) {
+#ifdef __BMI2__
+        embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square(this, &a, &p, inv_word);
+#else
+        runtime_fpbase_384_square(this, &a, &p, inv_word);
+#endif
+    }
+
     template <>
     inline void FpBase<384>::montgomery_reduce(BigInt<768>& __restrict a, const BigInt<384>& __restrict p, typename BigInt<384>::word_t inv_word) {
 #ifdef __BMI2__
         embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_montgomery_reduce(this, &a, &p, inv_word);
 #else
         runtime_fpbase_384_montgomery_reduce(this, &a, &p, inv_word);
+#endif
+    }
+
+    template <>
+    inline void FpDoubleBase<384>::add(const FpDoubleBase<384>& a, const FpDoubleBase<384>& __restrict b, const BigInt<384>& __restrict p) {
+        embedded_pairing_core_arch_x86_64_fpdouble_384_add(this, &a, &b, &p);
+    }
+
+    template <>
+    inline void FpDoubleBase<384>::subtract(const FpDoubleBase<384>& a, const FpDoubleBase<384>& __restrict b, const BigInt<384>& __restrict p) {
+        embedded_pairing_core_arch_x86_64_fpdouble_384_subtract(this, &a, &b, &p);
+    }
+
+    /*
+     * The 256-bit routines below are used for Fr. The multiplication and
+     * reduction routines assume that p < 2^255.
+     */
+
+    template <>
+    inline void FpBase<256>::add(const FpBase<256>& a, const FpBase<256>& __restrict b, const BigInt<256>& __restrict p) {
+        embedded_pairing_core_arch_x86_64_fpbase_256_add(this, &a, &b, &p);
+    }
+
+    template <>
+    inline void FpBase<256>::subtract(const FpBase<256>& a, const FpBase<256>& __restrict b, const BigInt<256>& __restrict p) {
+        embedded_pairing_core_arch_x86_64_fpbase_256_subtract(this, &a, &b, &p);
+    }
+
+    template <>
+    inline void FpBase<256>::multiply2(const FpBase<256>& a, const BigInt<256>& __restrict p) {
+        embedded_pairing_core_arch_x86_64_fpbase_256_multiply2(this, &a, &p);
+    }
+
+    template <>
+    inline void FpBase<256>::multiply(const FpBase<256>& a, const FpBase<256>& b, const BigInt<256>& __restrict p, typename BigInt<256>::word_t inv_word) {
+#ifdef __BMI2__
+        embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply(this, &a, &b, &p, inv_word);
+#else
+        runtime_fpbase_256_multiply(this, &a, &b, &p, inv_word);
+#endif
+    }
+
+    template <>
+    inline void FpBase<256>::square(const FpBase<256>& a, const BigInt<256>& __restrict p, typename BigInt<256>::word_t inv_word) {
+#ifdef __BMI2__
+        embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square(this, &a, &p, inv_word);
+#else
+        runtime_fpbase_256_square(this, &a, &p, inv_word);
+#endif
+    }
+
+    template <>
+    inline void FpBase<256>::montgomery_reduce(BigInt<512>& __restrict a, const BigInt<256>& __restrict p, typename BigInt<256>::word_t inv_word) {
+#ifdef __BMI2__
+        embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce(this, &a, &p, inv_word);
+#else
+        runtime_fpbase_256_montgomery_reduce(this, &a, &p, inv_word);
 #endif
     }
 }
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#ifndef EMBEDDED_PAIRING_CORE_ARCH_X86_64_FP_BATCH_HPP_
+#define EMBEDDED_PAIRING_CORE_ARCH_X86_64_FP_BATCH_HPP_
+
+/*
+ * The AVX2 implementation is only selected at runtime on CPUs without
+ * BMI2/ADX, so it is exposed here for tests and benchmarks to call directly.
+ * It must only be called if the CPU supports AVX2.
+ */
+extern "C" {
+    bool embedded_pairing_core_arch_x86_64_cpu_supports_avx2(void);
+    void embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
+}
+
+namespace embedded_pairing::core {
+    /*
+     * These point to the AVX-512 IFMA implementation if the CPU supports it,
+     * to the AVX2 implementation if the CPU supports AVX2 but not BMI2/ADX,
+     * and to a scalar implementation otherwise.
+     */
+    extern void (*runtime_fpbatch_384_multiply)(void*, const void*, const void*, const void*, uint64_t);
+    extern void (*runtime_fpbatch_384_square)(void*, const void*, const void*, uint64_t);
+
+    template <>
+    inline void FpBatchBase<384>::multiply(const FpBatchBase<384>& a, const FpBatchBase<384>& b, const BigInt<384>& __restrict p, typename BigInt<384>::word_t inv_word) {
+        runtime_fpbatch_384_multiply(this, &a, &b, &p, inv_word);
+    }
+
+    template <>
+    inline void FpBatchBase<384>::square(const FpBatchBase<384>& a, const BigInt<384>& __restrict p, typename BigInt<384>::word_t inv_word) {
+        runtime_fpbatch_384_square(this, &a, &p, inv_word);
+    }
+}
+
+#endif
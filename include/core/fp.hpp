@@ -171,6 +171,65 @@ namespace embedded_pairing::core {
         }
     };
 
+    /*
+     * The struct FpDoubleBase<bits> is a POD representing an unreduced
+     * product of two elements of FpBase<bits>, kept in the range
+     * [0, p * 2^bits). Sums and differences of such products can be
+     * accumulated without Montgomery reduction, and any value in this range
+     * can be brought back into Fp with a single montgomery_reduce. This lets
+     * the extension fields reduce once per output coefficient, rather than
+     * once per product.
+     */
+    template <int bits>
+    struct FpDoubleBase {
+        /* The only element of this struct. */
+        BigInt<2*bits> val;
+
+        void copy(const FpDoubleBase<bits>& a) {
+            this->val.copy(a.val);
+        }
+
+        /* Adds modulo p * 2^bits. */
+        void add(const FpDoubleBase<bits>& a, const FpDoubleBase<bits>& __restrict b, const BigInt<bits>& __restrict p) {
+            BigInt<bits>* upper = reinterpret_cast<BigInt<bits>*>(&this->val.bytes[bits/8]);
+#ifdef RESIST_SIDE_CHANNELS
+            BigInt<bits> tmp;
+#endif
+            this->val.add(a.val, b.val);
+            if (BigInt<bits>::compare(*upper, p) >= 0) {
+                upper->subtract(*upper, p);
+            } else {
+#ifdef RESIST_SIDE_CHANNELS
+                tmp.subtract(*upper, p);
+#endif
+            }
+        }
+
+        /* Subtracts modulo p * 2^bits. */
+        void subtract(const FpDoubleBase<bits>& a, const FpDoubleBase<bits>& __restrict b, const BigInt<bits>& __restrict p) {
+            BigInt<bits>* upper = reinterpret_cast<BigInt<bits>*>(&this->val.bytes[bits/8]);
+#ifdef RESIST_SIDE_CHANNELS
+            BigInt<bits> tmp;
+#endif
+            bool borrow = this->val.subtract(a.val, b.val);
+            if (borrow) {
+                upper->add(*upper, p);
+            } else {
+#ifdef RESIST_SIDE_CHANNELS
+                tmp.add(*upper, p);
+#endif
+            }
+        }
+
+        void multiply(const FpBase<bits>& a, const FpBase<bits>& b) {
+            this->val.multiply(a.val, b.val);
+        }
+
+        void square(const FpBase<bits>& a) {
+            this->val.square(a.val);
+        }
+    };
+
     /*
      * The struct Fp<bits, p, r, r2, mpinv> is a POD representing
      * an integer in Fp in Montgomery form. An integer x in [0, p-1] is
@@ -294,6 +353,14 @@ namespace embedded_pairing::core {
             this->FpBase<bits>::montgomery_reduce(a, p, inv.words[0]);
         }
 
+        /*
+         * Reduces an unreduced product (or sum of products) into this. The
+         * contents of a are destroyed.
+         */
+        void montgomery_reduce(FpDoubleBase<bits>& __restrict a) {
+            this->FpBase<bits>::montgomery_reduce(a.val, p, inv.words[0]);
+        }
+
         void __attribute__((noinline)) multiply(const Fp<bits, p, r, r2, inv>& a, const Fp<bits, p, r, r2, inv>& b) {
             this->FpBase<bits>::multiply(a, b, p, inv.words[0]);
         }
@@ -337,6 +404,21 @@ namespace embedded_pairing::core {
     /* TODO: Figure out how to make this definition constexpr. */
     template <int bits, const BigInt<bits>& p, const BigInt<bits>& r, const BigInt<bits>& r2, const BigInt<bits>& inv>
     const Fp<bits, p, r, r2, inv> Fp<bits, p, r, r2, inv>::one = {{ .val = r }};
+
+    /*
+     * The struct FpDouble<bits, p> wraps FpDoubleBase<bits> for a particular
+     * prime modulus, in the same way that Fp wraps FpBase.
+     */
+    template <int bits, const BigInt<bits>& p>
+    struct FpDouble : FpDoubleBase<bits> {
+        void add(const FpDouble<bits, p>& a, const FpDouble<bits, p>& __restrict b) {
+            this->FpDoubleBase<bits>::add(a, b, p);
+        }
+
+        void subtract(const FpDouble<bits, p>& a, const FpDouble<bits, p>& __restrict b) {
+            this->FpDoubleBase<bits>::subtract(a, b, p);
+        }
+    };
 }
 
 #ifndef DISABLE_ASM
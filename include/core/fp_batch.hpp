@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBEDDED_PAIRING_CORE_FP_BATCH_HPP_
+#define EMBEDDED_PAIRING_CORE_FP_BATCH_HPP_
+
+#include <stddef.h>
+
+#include "./bigint.hpp"
+#include "./fp.hpp"
+
+namespace embedded_pairing::core {
+    /*
+     * The struct FpBatchBase<bits> is a POD holding FpBatchBase<bits>::lanes
+     * independent elements of FpBase<bits> in structure-of-arrays form: word
+     * i of lane j is stored in words[i][j]. Each lane uses the same
+     * Montgomery representation as FpBase<bits>, so elements move in and out
+     * of a batch by transposing their words.
+     *
+     * Normally you would use FpBatch, which inherits from this struct. The
+     * multiply and square methods are the parts that lend themselves to
+     * architecture-specific (i.e., vectorized) implementations; the generic
+     * versions below simply process one lane at a time.
+     */
+    template <int bits>
+    struct FpBatchBase {
+        typedef typename BigInt<bits>::word_t word_t;
+
+        static constexpr int lanes = 8;
+        static constexpr int word_length = BigInt<bits>::word_length;
+
+        /* The only element of this struct. */
+        alignas(64) word_t words[word_length][lanes];
+
+        void load_lane(int lane, const FpBase<bits>& a) {
+            for (int i = 0; i != word_length; i++) {
+                this->words[i][lane] = a.val.words[i];
+            }
+        }
+
+        void store_lane(int lane, FpBase<bits>& a) const {
+            for (int i = 0; i != word_length; i++) {
+                a.val.words[i] = this->words[i][lane];
+            }
+        }
+
+        void multiply(const FpBatchBase<bits>& a, const FpBatchBase<bits>& b, const BigInt<bits>& __restrict p, word_t inv_word) {
+            FpBase<bits> x;
+            FpBase<bits> y;
+            for (int lane = 0; lane != lanes; lane++) {
+                a.store_lane(lane, x);
+                b.store_lane(lane, y);
+                x.multiply(x, y, p, inv_word);
+                this->load_lane(lane, x);
+            }
+        }
+
+        void square(const FpBatchBase<bits>& a, const BigInt<bits>& __restrict p, word_t inv_word) {
+            FpBase<bits> x;
+            for (int lane = 0; lane != lanes; lane++) {
+                a.store_lane(lane, x);
+                x.square(x, p, inv_word);
+                this->load_lane(lane, x);
+            }
+        }
+    };
+
+    /*
+     * The struct FpBatch<Fp> is a batch of elements of Fp, which must be an
+     * instantiation of the Fp template (e.g., Fq). See FpBatchBase.
+     */
+    template <typename Fp>
+    struct FpBatch : FpBatchBase<Fp::bits_value> {
+        static constexpr int lanes = FpBatchBase<Fp::bits_value>::lanes;
+
+        /* Loads lanes elements from the array a. */
+        void load(const Fp* a) {
+            for (int lane = 0; lane != lanes; lane++) {
+                this->load_lane(lane, a[lane]);
+            }
+        }
+
+        /*
+         * Loads count elements from the array a, where count may be less than
+         * lanes. The remaining lanes are set to zero.
+         */
+        void load(const Fp* a, int count) {
+            for (int lane = 0; lane != lanes; lane++) {
+                if (lane < count) {
+                    this->load_lane(lane, a[lane]);
+                } else {
+                    this->load_lane(lane, Fp::zero);
+                }
+            }
+        }
+
+        /* Stores the first count lanes into the array a. */
+        void store(Fp* a, int count = lanes) const {
+            for (int lane = 0; lane != count; lane++) {
+                this->store_lane(lane, a[lane]);
+            }
+        }
+
+        void multiply(const FpBatch<Fp>& a, const FpBatch<Fp>& b) {
+            this->FpBatchBase<Fp::bits_value>::multiply(a, b, Fp::p_value, Fp::inv_value.words[0]);
+        }
+
+        void square(const FpBatch<Fp>& a) {
+            this->FpBatchBase<Fp::bits_value>::square(a, Fp::p_value, Fp::inv_value.words[0]);
+        }
+    };
+
+    /*
+     * Sets res[i] = a[i] * b[i] for i in [0, n), a batch at a time. Any of
+     * res, a, and b may be the same array.
+     */
+    template <typename Fp>
+    void batch_multiply(Fp* res, const Fp* a, const Fp* b, size_t n) {
+        FpBatch<Fp> x;
+        FpBatch<Fp> y;
+        for (size_t i = 0; i < n; i += FpBatch<Fp>::lanes) {
+            int count = (n - i < FpBatch<Fp>::lanes) ? (int) (n - i) : FpBatch<Fp>::lanes;
+            x.load(&a[i], count);
+            y.load(&b[i], count);
+            x.multiply(x, y);
+            x.store(&res[i], count);
+        }
+    }
+
+    /* Sets res[i] = a[i] ^ 2 for i in [0, n), a batch at a time. */
+    template <typename Fp>
+    void batch_square(Fp* res, const Fp* a, size_t n) {
+        FpBatch<Fp> x;
+        for (size_t i = 0; i < n; i += FpBatch<Fp>::lanes) {
+            int count = (n - i < FpBatch<Fp>::lanes) ? (int) (n - i) : FpBatch<Fp>::lanes;
+            x.load(&a[i], count);
+            x.square(x);
+            x.store(&res[i], count);
+        }
+    }
+}
+
+#ifndef DISABLE_ASM
+
+#if defined(__x86_64__) || defined(_M_X64_)
+#include "./arch/x86_64/fp_batch.hpp"
+#endif
+
+#endif /* DISABLE_ASM */
+
+#endif
@@ -33,6 +33,8 @@
 #ifndef EMBEDDED_PAIRING_CORE_FP_UTILS_HPP_
 #define EMBEDDED_PAIRING_CORE_FP_UTILS_HPP_
 
+#include <stddef.h>
+
 #include "./bigint.hpp"
 #include "./fp.hpp"
 
@@ -92,12 +94,324 @@ namespace embedded_pairing::core {
         res.copy(tmp);
     }
 
+    /*
+     * Exponentiation by a fixed, public exponent (e.g., (p + 1) / 4 for a
+     * square root) using a sliding window of WINDOW bits over a table of odd
+     * powers of the base. This needs far fewer multiplications than plain
+     * square-and-multiply for dense exponents. The sequence of operations
+     * depends only on the exponent, not the base, so this is suitable for
+     * secret bases but not secret exponents.
+     */
+    template <int window, typename F, typename Power>
+    void exponentiate_fixed(F& res, const F& a, const Power& __restrict power) {
+        static_assert(window >= 1 && window <= 8, "unsupported window size");
+
+        /* table[i] = a^(2i + 1) */
+        F table[1 << (window - 1)];
+        table[0].copy(a);
+        if constexpr(window > 1) {
+            F a2;
+            a2.square(a);
+            for (int i = 1; i != (1 << (window - 1)); i++) {
+                table[i].multiply(table[i - 1], a2);
+            }
+        }
+
+        int i = Power::bits_value - 1;
+        while (i != -1 && !power.bit(i)) {
+            i--;
+        }
+
+        F tmp;
+        tmp.copy(F::one);
+        bool found_one = false;
+        while (i != -1) {
+            if (!power.bit(i)) {
+                tmp.square(tmp);
+                i--;
+                continue;
+            }
+
+            /* Find the longest window ending in a one bit, of bits i..j. */
+            int j = (i >= window - 1) ? (i - window + 1) : 0;
+            while (!power.bit(j)) {
+                j++;
+            }
+            unsigned int digit = 0;
+            for (int k = i; k != j - 1; k--) {
+                digit = (digit << 1) | (power.bit(k) ? 1 : 0);
+            }
+
+            if (found_one) {
+                for (int k = i; k != j - 1; k--) {
+                    tmp.square(tmp);
+                }
+                tmp.multiply(tmp, table[digit >> 1]);
+            } else {
+                tmp.copy(table[digit >> 1]);
+                found_one = true;
+            }
+            i = j - 1;
+        }
+        res.copy(tmp);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    /*
+     * Constant-time modular inversion using the "safegcd" algorithm of
+     * Bernstein and Yang ("Fast constant-time gcd computation and modular
+     * inversion", 2019), following the structure of the implementation in
+     * libsecp256k1. Numbers are kept in a signed representation with 62-bit
+     * limbs, so that 62 divsteps can be computed at a time using only the
+     * bottom limb of f and g, after which the full-size values are updated
+     * with the resulting 2x2 transition matrix.
+     *
+     * The number of divsteps is the bound from Theorem 11.2 of the paper for
+     * inputs of the given size, so the running time does not depend on the
+     * input. This requires 128-bit integer support.
+     */
+    template <int bits>
+    struct SafeGcd {
+        static constexpr int limb_bits = 62;
+        static constexpr uint64_t limb_mask = (UINT64_C(1) << limb_bits) - 1;
+        static constexpr int num_limbs = (bits + 2 + limb_bits - 1) / limb_bits;
+        static constexpr int num_divsteps = (49 * bits + 57) / 17;
+        static constexpr int num_iterations = (num_divsteps + limb_bits - 1) / limb_bits;
+
+        typedef __int128 int128_t;
+
+        /*
+         * The value is the sum of v[i] * 2^(62 * i). All limbs except the
+         * last are in [0, 2^62); the last limb carries the sign.
+         */
+        struct Signed62 {
+            int64_t v[num_limbs];
+        };
+
+        /*
+         * Transition matrix for 62 divsteps, scaled by 2^62. Each row has
+         * an absolute sum of at most 2^62.
+         */
+        struct Matrix {
+            int64_t u;
+            int64_t v;
+            int64_t q;
+            int64_t r;
+        };
+
+        static void from_bigint(Signed62& res, const BigInt<bits>& a) {
+            typedef typename BigInt<bits>::word_t word_t;
+            constexpr int word_bits = sizeof(word_t) * 8;
+            for (int i = 0; i != num_limbs; i++) {
+                int w = (limb_bits * i) / word_bits;
+                int shift = (limb_bits * i) % word_bits;
+                uint64_t limb = 0;
+                if (w < BigInt<bits>::word_length) {
+                    limb = a.words[w] >> shift;
+                    if (shift + limb_bits > word_bits && w + 1 < BigInt<bits>::word_length) {
+                        limb |= a.words[w + 1] << (word_bits - shift);
+                    }
+                }
+                res.v[i] = (int64_t) (limb & limb_mask);
+            }
+        }
+
+        /* The value must be in [0, 2^bits) with all limbs normalized. */
+        static void to_bigint(BigInt<bits>& res, const Signed62& a) {
+            typedef typename BigInt<bits>::word_t word_t;
+            constexpr int word_bits = sizeof(word_t) * 8;
+            for (int w = 0; w != BigInt<bits>::word_length; w++) {
+                res.words[w] = 0;
+            }
+            for (int i = 0; i != num_limbs; i++) {
+                int w = (limb_bits * i) / word_bits;
+                int shift = (limb_bits * i) % word_bits;
+                uint64_t limb = (uint64_t) a.v[i];
+                if (w < BigInt<bits>::word_length) {
+                    res.words[w] |= limb << shift;
+                    if (shift + limb_bits > word_bits && w + 1 < BigInt<bits>::word_length) {
+                        res.words[w + 1] |= limb >> (word_bits - shift);
+                    }
+                }
+            }
+        }
+
+        /*
+         * Performs 62 divsteps on the bottom limbs of f and g, without
+         * branches. Each divstep is
+         *   (delta, f, g) -> (1 - delta, g, (g - f) / 2) if delta > 0 and g is odd,
+         *   (delta, f, g) -> (1 + delta, f, (g + (g mod 2) f) / 2) otherwise.
+         */
+        static int64_t divsteps(int64_t delta, uint64_t f, uint64_t g, Matrix& t) {
+            uint64_t u = 1;
+            uint64_t v = 0;
+            uint64_t q = 0;
+            uint64_t r = 1;
+            for (int i = 0; i != limb_bits; i++) {
+                /* Masks for delta > 0, g odd, and both (i.e., swap). */
+                uint64_t c1 = (uint64_t) ((-delta) >> 63);
+                uint64_t c2 = -(g & 1);
+                uint64_t swap = c1 & c2;
+
+                /* Add f (or -f, when swapping) to g if g is odd. */
+                uint64_t x = (f ^ swap) - swap;
+                uint64_t y = (u ^ swap) - swap;
+                uint64_t z = (v ^ swap) - swap;
+                g += x & c2;
+                q += y & c2;
+                r += z & c2;
+
+                /* When swapping, this sets f to the old value of g. */
+                f += g & swap;
+                u += q & swap;
+                v += r & swap;
+
+                delta = 1 + (int64_t) (((uint64_t) delta ^ swap) - swap);
+                g >>= 1;
+                u <<= 1;
+                v <<= 1;
+            }
+            t.u = (int64_t) u;
+            t.v = (int64_t) v;
+            t.q = (int64_t) q;
+            t.r = (int64_t) r;
+            return delta;
+        }
+
+        /* Sets (f, g) = t (f, g) / 2^62, which is exact. */
+        static void update_fg(Signed62& f, Signed62& g, const Matrix& t) {
+            int128_t cf = (int128_t) t.u * f.v[0] + (int128_t) t.v * g.v[0];
+            int128_t cg = (int128_t) t.q * f.v[0] + (int128_t) t.r * g.v[0];
+            cf >>= limb_bits;
+            cg >>= limb_bits;
+            for (int i = 1; i != num_limbs; i++) {
+                cf += (int128_t) t.u * f.v[i] + (int128_t) t.v * g.v[i];
+                cg += (int128_t) t.q * f.v[i] + (int128_t) t.r * g.v[i];
+                f.v[i - 1] = (int64_t) ((uint64_t) cf & limb_mask);
+                g.v[i - 1] = (int64_t) ((uint64_t) cg & limb_mask);
+                cf >>= limb_bits;
+                cg >>= limb_bits;
+            }
+            f.v[num_limbs - 1] = (int64_t) cf;
+            g.v[num_limbs - 1] = (int64_t) cg;
+        }
+
+        /*
+         * Sets (d, e) = t (d, e) / 2^62 mod p. Multiples of p are added so
+         * that the division is exact and so that, given d and e in (-2p, p),
+         * the results are also in (-2p, p). p_inv is p^-1 mod 2^62.
+         */
+        static void update_de(Signed62& d, Signed62& e, const Matrix& t, const Signed62& p, uint64_t p_inv) {
+            int64_t sd = d.v[num_limbs - 1] >> 63;
+            int64_t se = e.v[num_limbs - 1] >> 63;
+            int64_t md = (t.u & sd) + (t.v & se);
+            int64_t me = (t.q & sd) + (t.r & se);
+
+            int128_t cd = (int128_t) t.u * d.v[0] + (int128_t) t.v * e.v[0];
+            int128_t ce = (int128_t) t.q * d.v[0] + (int128_t) t.r * e.v[0];
+
+            /* Choose md and me so that the bottom 62 bits cancel. */
+            md -= (int64_t) ((p_inv * (uint64_t) cd + (uint64_t) md) & limb_mask);
+            me -= (int64_t) ((p_inv * (uint64_t) ce + (uint64_t) me) & limb_mask);
+            cd += (int128_t) p.v[0] * md;
+            ce += (int128_t) p.v[0] * me;
+            cd >>= limb_bits;
+            ce >>= limb_bits;
+
+            for (int i = 1; i != num_limbs; i++) {
+                cd += (int128_t) t.u * d.v[i] + (int128_t) t.v * e.v[i] + (int128_t) p.v[i] * md;
+                ce += (int128_t) t.q * d.v[i] + (int128_t) t.r * e.v[i] + (int128_t) p.v[i] * me;
+                d.v[i - 1] = (int64_t) ((uint64_t) cd & limb_mask);
+                e.v[i - 1] = (int64_t) ((uint64_t) ce & limb_mask);
+                cd >>= limb_bits;
+                ce >>= limb_bits;
+            }
+            d.v[num_limbs - 1] = (int64_t) cd;
+            e.v[num_limbs - 1] = (int64_t) ce;
+        }
+
+        static void carry(Signed62& r) {
+            for (int i = 0; i != num_limbs - 1; i++) {
+                r.v[i + 1] += r.v[i] >> limb_bits;
+                r.v[i] &= (int64_t) limb_mask;
+            }
+        }
+
+        /*
+         * Given r in (-2p, p), sets r to r mod p if sign is nonnegative, and
+         * to -r mod p if sign is negative, in [0, p).
+         */
+        static void normalize(Signed62& r, int64_t sign, const Signed62& p) {
+            int64_t add = r.v[num_limbs - 1] >> 63;
+            int64_t negate = sign >> 63;
+            for (int i = 0; i != num_limbs; i++) {
+                r.v[i] += p.v[i] & add;
+                r.v[i] = (r.v[i] ^ negate) - negate;
+            }
+            carry(r);
+
+            add = r.v[num_limbs - 1] >> 63;
+            for (int i = 0; i != num_limbs; i++) {
+                r.v[i] += p.v[i] & add;
+            }
+            carry(r);
+        }
+
+        /*
+         * Sets res = a^-1 mod p, or zero if a is zero. p must be odd and
+         * inv_word must be -p^-1 modulo the word size.
+         */
+        static void inverse(BigInt<bits>& res, const BigInt<bits>& a, const BigInt<bits>& p, uint64_t inv_word) {
+            Signed62 modulus;
+            from_bigint(modulus, p);
+            uint64_t p_inv = (0 - inv_word) & limb_mask;
+
+            Signed62 d;
+            Signed62 e;
+            for (int i = 0; i != num_limbs; i++) {
+                d.v[i] = 0;
+                e.v[i] = 0;
+            }
+            e.v[0] = 1;
+
+            Signed62 f = modulus;
+            Signed62 g;
+            from_bigint(g, a);
+
+            int64_t delta = 1;
+            for (int i = 0; i != num_iterations; i++) {
+                Matrix t;
+                delta = divsteps(delta, (uint64_t) f.v[0], (uint64_t) g.v[0], t);
+                update_de(d, e, t, modulus, p_inv);
+                update_fg(f, g, t);
+            }
+
+            /* Now g is zero and f is +/- gcd(a, p), so d = +/- a^-1. */
+            normalize(d, f.v[num_limbs - 1], modulus);
+            to_bigint(res, d);
+        }
+    };
+#endif
+
     /*
      * We define these as separate functions for reason #2 above
      * (reason #1 does not apply here).
      */
     template <typename Fp>
     void fp_inverse(Fp& res, const Fp& a) {
+#if defined(__SIZEOF_INT128__)
+        /*
+         * The inverse of a's Montgomery representation, aR, is a^-1 R^-1, so
+         * two Montgomery multiplications by R^2 bring it to a^-1 R.
+         */
+        Fp tmp;
+        SafeGcd<Fp::bits_value>::inverse(tmp.val, a.val, Fp::p_value, Fp::inv_value.words[0]);
+
+        Fp r2;
+        r2.copy(Fp::r2_value);
+        tmp.multiply(tmp, r2);
+        res.multiply(tmp, r2);
+#else
         /* Algorithm below will not terminate for a = 0, so check if it is. */
         if (a.is_zero()) {
             res.set_zero();
@@ -142,6 +456,54 @@ namespace embedded_pairing::core {
         } else {
             res.copy(c);
         }
+#endif
+    }
+
+    /*
+     * Inverts each of the n elements of IN, writing the results to OUT,
+     * using Montgomery's trick: one inversion and 3(n - 1) multiplications
+     * in total. Zero elements are mapped to zero, as in the single-element
+     * inverse, and do not affect the other results. OUT is used to store
+     * the running products, so IN and OUT must not overlap.
+     *
+     * This works for any type F providing is_zero, copy, multiply, inverse,
+     * and static members "zero" and "one" (Fq, Fq2, Fq12, Fr, ...). Which
+     * elements are zero is not hidden from side channels.
+     */
+    template <typename F>
+    void batch_inverse(F* __restrict out, const F* __restrict in, size_t n) {
+        if (n == 0) {
+            return;
+        }
+
+        /* out[i] is the product of the nonzero elements among in[0..i]. */
+        out[0].copy(in[0].is_zero() ? F::one : in[0]);
+        for (size_t i = 1; i != n; i++) {
+            if (in[i].is_zero()) {
+                out[i].copy(out[i - 1]);
+            } else {
+                out[i].multiply(out[i - 1], in[i]);
+            }
+        }
+
+        F acc;
+        acc.inverse(out[n - 1]);
+
+        /* Invariant: acc is the inverse of the product in out[i]. */
+        for (size_t i = n - 1; i != 0; i--) {
+            if (in[i].is_zero()) {
+                out[i].copy(F::zero);
+            } else {
+                out[i].multiply(acc, out[i - 1]);
+                acc.multiply(acc, in[i]);
+            }
+        }
+
+        if (in[0].is_zero()) {
+            out[0].copy(F::zero);
+        } else {
+            out[0].copy(acc);
+        }
     }
 }
 
@@ -130,6 +130,7 @@ namespace embedded_pairing::lqibe {
 
     void setup(Params& params, MasterKey& msk, void (*get_random_bytes)(void*, size_t));
     void keygen(SecretKey& sk, const MasterKey& msk, const ID& id);
+    void keygen_batch(SecretKey* sks, const MasterKey& msk, const ID* ids, size_t n);
     void encrypt(Ciphertext& ciphertext, void* symmetric, size_t symmetric_length, const Params& params, const ID& id, void (*hash_fill)(void*, size_t, const void*, size_t), void (*get_random_bytes)(void*, size_t));
     void decrypt(void* symmetric, size_t symmetric_length, const Ciphertext& ciphertext, const SecretKey& sk, const ID& id, void (*hash_fill)(void*, size_t, const void*, size_t));
 }
@@ -80,6 +80,7 @@ void embedded_pairing_lqibe_compute_id_from_hash(embedded_pairing_lqibe_id_t* id
 
 void embedded_pairing_lqibe_setup(embedded_pairing_lqibe_params_t* params, embedded_pairing_lqibe_masterkey_t* msk, void (*get_random_bytes)(void*, size_t));
 void embedded_pairing_lqibe_keygen(embedded_pairing_lqibe_secretkey_t* sk, const embedded_pairing_lqibe_masterkey_t* msk, const embedded_pairing_lqibe_id_t* id);
+void embedded_pairing_lqibe_keygen_batch(embedded_pairing_lqibe_secretkey_t* sks, const embedded_pairing_lqibe_masterkey_t* msk, const embedded_pairing_lqibe_id_t* ids, size_t n);
 void embedded_pairing_lqibe_encrypt(embedded_pairing_lqibe_ciphertext_t* ciphertext, void* symmetric, size_t symmetric_length, const embedded_pairing_lqibe_params_t* params, const embedded_pairing_lqibe_id_t* id, void (*hash_fill)(void*, size_t, const void*, size_t), void (*get_random_bytes)(void*, size_t));
 void embedded_pairing_lqibe_decrypt(void* symmetric, size_t symmetric_length, const embedded_pairing_lqibe_ciphertext_t* ciphertext, const embedded_pairing_lqibe_secretkey_t* sk, const embedded_pairing_lqibe_id_t* id, void (*hash_fill)(void*, size_t, const void*, size_t));
 
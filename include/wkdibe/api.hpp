@@ -42,6 +42,7 @@
 #include "bls12_381/curve.hpp"
 #include "bls12_381/pairing.hpp"
 #include "bls12_381/decomposition.hpp"
+#include "bls12_381/fixed_base.hpp"
 
 namespace embedded_pairing::wkdibe {
     typedef bls12_381::G1 G1;
@@ -79,33 +80,41 @@ namespace embedded_pairing::wkdibe {
         G1* h;
         int l;
 
-        template <bool compressed>
+        /*
+         * If COMPRESSED_GT is true, the pairing is encoded in compressed (torus)
+         * form, halving its size. This only matters for uncompressed Params,
+         * since compressed Params omit the pairing entirely.
+         */
+        template <bool compressed, bool compressed_gt = false>
         void marshal(void* buffer) const;
 
-        template <bool compressed>
+        template <bool compressed, bool compressed_gt = false>
         bool unmarshal(const void* buffer, bool checked);
 
-        template <bool compressed>
+        template <bool compressed, bool compressed_gt = false>
         inline int setLength(const void* marshalled, size_t marshalledLength) {
-            int len = Params::unmarshalledLength<compressed>(marshalled, marshalledLength);
+            int len = Params::unmarshalledLength<compressed, compressed_gt>(marshalled, marshalledLength);
             if (len != -1) {
                 this->l = len;
             }
             return len;
         }
 
-        template <bool compressed>
+        template <bool compressed, bool compressed_gt = false>
         inline size_t getMarshalledLength(void) const {
-            return Params::marshalledLength<compressed>(this->l, this->signatures);
+            return Params::marshalledLength<compressed, compressed_gt>(this->l, this->signatures);
         }
 
         template <bool compressed>
         static constexpr size_t marshalledLengthMinimum = 1 + 2 * bls12_381::Encoding<G1Affine, compressed>::size + 2 * bls12_381::Encoding<G2Affine, compressed>::size;
 
-        template <bool compressed>
+        template <bool compressed, bool compressed_gt>
+        static constexpr size_t marshalledPairingLength = compressed ? 0 : bls12_381::Encoding<GT, compressed_gt>::size;
+
+        template <bool compressed, bool compressed_gt = false>
         static constexpr int unmarshalledLength(const void* marshalled, size_t marshalledLength) {
             uint8_t firstByte = *((uint8_t*) marshalled);
-            size_t withoutLength = Params::marshalledLengthMinimum<compressed> + (compressed ? 0 : sizeof(GT)) + (firstByte == 0 ? 0 : bls12_381::Encoding<G1Affine, compressed>::size);
+            size_t withoutLength = Params::marshalledLengthMinimum<compressed> + Params::marshalledPairingLength<compressed, compressed_gt> + (firstByte == 0 ? 0 : bls12_381::Encoding<G1Affine, compressed>::size);
             if (marshalledLength < withoutLength) {
                 return -1;
             }
@@ -113,9 +122,9 @@ namespace embedded_pairing::wkdibe {
             return (hsize % bls12_381::Encoding<G1Affine, compressed>::size) == 0 ? (hsize / bls12_381::Encoding<G1Affine, compressed>::size) : -1;
         }
 
-        template <bool compressed>
+        template <bool compressed, bool compressed_gt = false>
         static constexpr size_t marshalledLength(int length, bool signatures) {
-            return Params::marshalledLengthMinimum<compressed> + (compressed ? 0 : sizeof(GT)) + ((signatures ? 1 : 0) + length) * bls12_381::Encoding<G1Affine, compressed>::size;
+            return Params::marshalledLengthMinimum<compressed> + Params::marshalledPairingLength<compressed, compressed_gt> + ((signatures ? 1 : 0) + length) * bls12_381::Encoding<G1Affine, compressed>::size;
         }
     };
 
@@ -124,14 +133,20 @@ namespace embedded_pairing::wkdibe {
         G2 b;
         G1 c;
 
-        template <bool compressed>
+        /*
+         * If COMPRESSED_GT is true, a is encoded in compressed (torus) form,
+         * halving its size. This requires the encrypted message to be in GT
+         * (e.g., chosen with random_gt), rather than an arbitrary element of
+         * Fq12.
+         */
+        template <bool compressed, bool compressed_gt = false>
         void marshal(void* buffer) const;
 
-        template <bool compressed>
+        template <bool compressed, bool compressed_gt = false>
         bool unmarshal(const void* buffer, bool checked);
 
-        template <bool compressed>
-        static constexpr size_t marshalledLength = bls12_381::Encoding<G1Affine, compressed>::size + bls12_381::Encoding<G2Affine, compressed>::size + sizeof(GT);
+        template <bool compressed, bool compressed_gt = false>
+        static constexpr size_t marshalledLength = bls12_381::Encoding<G1Affine, compressed>::size + bls12_381::Encoding<G2Affine, compressed>::size + bls12_381::Encoding<GT, compressed_gt>::size;
     };
 
     struct Signature {
@@ -268,6 +283,24 @@ namespace embedded_pairing::wkdibe {
 
     void encrypt(Ciphertext& ciphertext, const GT& message, const Params& params, const AttributeList& attrs, void (*get_random_bytes)(void*, size_t));
     void encrypt_precomputed(Ciphertext& ciphertext, const GT& message, const Params& params, const Precomputed& precomputed, void (*get_random_bytes)(void*, size_t));
+
+    /*
+     * Same as encrypt_precomputed, but raises params.pairing using a table
+     * filled (once per Params) with pairing_table.fill_table(params.pairing).
+     * This is worthwhile when encrypting many messages with the same Params.
+     */
+    template <unsigned int teeth, unsigned int blocks>
+    void encrypt_precomputed(Ciphertext& ciphertext, const GT& message, const Params& params, const Precomputed& precomputed, const bls12_381::GTFixedBaseTable<teeth, blocks>& pairing_table, void (*get_random_bytes)(void*, size_t)) {
+        bls12_381::PowersOfX sx;
+        Scalar s;
+        random_zpstar(sx, s, get_random_bytes);
+
+        pairing_table.exponentiate(ciphertext.a, sx);
+        ciphertext.a.multiply(ciphertext.a, message);
+        ciphertext.b.multiply_frobenius(params.g, sx);
+        ciphertext.c.multiply(precomputed.prodexp, s);
+    }
+
     void decrypt(GT& message, const Ciphertext& ciphertext, const SecretKey& sk);
     void decrypt_master(GT& message, const Ciphertext& ciphertext, const MasterKey& msk);
 
@@ -37,10 +37,46 @@ package bls12381
 
 /*
 #cgo CFLAGS: -I ../../../include
-#cgo LDFLAGS: ${SRCDIR}/pairing.a
+#cgo LDFLAGS: ${SRCDIR}/pairing.a -lpthread
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include "bls12_381/bls12_381.h"
+
+typedef struct {
+	void (*task)(void*, size_t);
+	void* arg;
+	size_t index;
+} thread_task_t;
+
+static void* run_thread_task(void* t) {
+	thread_task_t* tt = t;
+	tt->task(tt->arg, tt->index);
+	return NULL;
+}
+
+// Runs each task on its own thread, with task 0 on the calling thread. This
+// must not be static, since Go takes its address.
+void thread_parallel_for(void* executor, void (*task)(void*, size_t), void* arg, size_t count) {
+	pthread_t threads[count];
+	thread_task_t tasks[count];
+	int started[count];
+	for (size_t i = 1; i < count; i++) {
+		tasks[i].task = task;
+		tasks[i].arg = arg;
+		tasks[i].index = i;
+		started[i] = (pthread_create(&threads[i], NULL, run_thread_task, &tasks[i]) == 0);
+		if (!started[i]) {
+			task(arg, i);
+		}
+	}
+	task(arg, 0);
+	for (size_t i = 1; i < count; i++) {
+		if (started[i]) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+}
 */
 import "C"
 import (
@@ -384,12 +420,11 @@ func (result *GT) PreparedPairing(a *G1Affine, b *G2Prepared) *GT {
 	return result
 }
 
-// PairingSum computes the sum of e(a[i], b[i]) for i = 0 ... len(a) - 1 and
-// e(c[j], d[j]) for j = 0 ... len(c) - 1 (so the sum of len(a) + len(c) terms
-// total), and stores the in result. It is significantly faster than computing
-// each term separately using Pairing() or PreparedPairing and then computing
-// the sum using Add.
-func (result *GT) PairingSum(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G2Prepared) *GT {
+// pairsToC copies the pairs (a[i], b[i]) and (c[j], d[j]) into C memory in
+// the form expected by the pairing product functions. The caller must call
+// the returned function to free the memory once it is done with the pairs.
+func pairsToC(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G2Prepared) (*C.embedded_pairing_bls12_381_affine_pair_t, C.size_t, *C.embedded_pairing_bls12_381_prepared_pair_t, C.size_t, func()) {
+	var affineBuffer unsafe.Pointer
 	var affinePairs *C.embedded_pairing_bls12_381_affine_pair_t
 	numAffinePairs := C.size_t(len(a))
 	if numAffinePairs != 0 {
@@ -398,7 +433,7 @@ func (result *GT) PairingSum(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G
 		pairsLen := numAffinePairs * C.sizeof_embedded_pairing_bls12_381_affine_pair_t
 
 		buffer := C.malloc(aLen + bLen + pairsLen)
-		defer C.free(buffer)
+		affineBuffer = buffer
 
 		affinePairs = (*C.embedded_pairing_bls12_381_affine_pair_t)(unsafe.Pointer(uintptr(buffer) + uintptr(aLen) + uintptr(bLen)))
 		for i := range a {
@@ -410,15 +445,16 @@ func (result *GT) PairingSum(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G
 		}
 	}
 
+	var preparedBuffer unsafe.Pointer
 	var preparedPairs *C.embedded_pairing_bls12_381_prepared_pair_t
 	numPreparedPairs := C.size_t(len(c))
 	if numPreparedPairs != 0 {
-		cLen := numAffinePairs * C.sizeof_embedded_pairing_bls12_381_g1affine_t
-		dLen := numAffinePairs * C.sizeof_embedded_pairing_bls12_381_g2prepared_t
-		pairsLen := numAffinePairs * C.sizeof_embedded_pairing_bls12_381_prepared_pair_t
+		cLen := numPreparedPairs * C.sizeof_embedded_pairing_bls12_381_g1affine_t
+		dLen := numPreparedPairs * C.sizeof_embedded_pairing_bls12_381_g2prepared_t
+		pairsLen := numPreparedPairs * C.sizeof_embedded_pairing_bls12_381_prepared_pair_t
 
 		buffer := C.malloc(cLen + dLen + pairsLen)
-		defer C.free(buffer)
+		preparedBuffer = buffer
 
 		preparedPairs = (*C.embedded_pairing_bls12_381_prepared_pair_t)(unsafe.Pointer(uintptr(buffer) + uintptr(cLen) + uintptr(dLen)))
 		for i := range c {
@@ -430,6 +466,50 @@ func (result *GT) PairingSum(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G
 		}
 	}
 
+	free := func() {
+		if affineBuffer != nil {
+			C.free(affineBuffer)
+		}
+		if preparedBuffer != nil {
+			C.free(preparedBuffer)
+		}
+	}
+	return affinePairs, numAffinePairs, preparedPairs, numPreparedPairs, free
+}
+
+// PairingSum computes the sum of e(a[i], b[i]) for i = 0 ... len(a) - 1 and
+// e(c[j], d[j]) for j = 0 ... len(c) - 1 (so the sum of len(a) + len(c) terms
+// total), and stores the in result. It is significantly faster than computing
+// each term separately using Pairing() or PreparedPairing and then computing
+// the sum using Add.
+func (result *GT) PairingSum(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G2Prepared) *GT {
+	affinePairs, numAffinePairs, preparedPairs, numPreparedPairs, free := pairsToC(a, b, c, d)
+	defer free()
+
 	C.embedded_pairing_bls12_381_pairing_sum(&result.Data, affinePairs, numAffinePairs, preparedPairs, numPreparedPairs)
 	return result
 }
+
+// PairingSumParallel is the same as PairingSum, but splits the pairs into up
+// to numThreads groups and computes the Miller loop for each group on its own
+// thread. This is worthwhile for large sums; a good choice for numThreads is
+// usually runtime.NumCPU().
+func (result *GT) PairingSumParallel(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G2Prepared, numThreads int) *GT {
+	affinePairs, numAffinePairs, preparedPairs, numPreparedPairs, free := pairsToC(a, b, c, d)
+	defer free()
+
+	C.embedded_pairing_bls12_381_pairing_sum_parallel(&result.Data, affinePairs, numAffinePairs, preparedPairs, numPreparedPairs, C.size_t(numThreads), C.embedded_pairing_bls12_381_parallel_for_t(C.thread_parallel_for), nil)
+	return result
+}
+
+// PairingCheck returns true if the sum of e(a[i], b[i]) for
+// i = 0 ... len(a) - 1 and e(c[j], d[j]) for j = 0 ... len(c) - 1 is zero. To
+// check an equation of pairings, move all of the terms to one side and use
+// this function; it is faster than computing each side with PairingSum and
+// comparing them with GTEqual.
+func PairingCheck(a []*G1Affine, b []*G2Affine, c []*G1Affine, d []*G2Prepared) bool {
+	affinePairs, numAffinePairs, preparedPairs, numPreparedPairs, free := pairsToC(a, b, c, d)
+	defer free()
+
+	return bool(C.embedded_pairing_bls12_381_pairing_check(affinePairs, numAffinePairs, preparedPairs, numPreparedPairs))
+}
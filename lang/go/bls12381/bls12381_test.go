@@ -421,6 +421,45 @@ func TestPairingSum(t *testing.T) {
 	}
 }
 
+func TestPairingSumParallel(t *testing.T) {
+	const n = 10
+	a := make([]*G1Affine, n)
+	b := make([]*G2Affine, n)
+	for i := 0; i != n; i++ {
+		a[i] = new(G1Affine).FromProjective(new(G1).Random())
+		b[i] = new(G2Affine).FromProjective(new(G2).Random())
+	}
+	c := []*G1Affine{new(G1Affine).FromProjective(new(G1).Random())}
+	d := []*G2Prepared{new(G2Prepared).Prepare(new(G2Affine).FromProjective(new(G2).Random()))}
+
+	expected := new(GT).PairingSum(a, b, c, d)
+	for numThreads := 1; numThreads != 5; numThreads++ {
+		pairsum := new(GT).PairingSumParallel(a, b, c, d, numThreads)
+		if !GTEqual(expected, pairsum) {
+			t.Fatal("Parallel pairing sum is incorrect")
+		}
+	}
+}
+
+func TestPairingCheck(t *testing.T) {
+	for i := 0; i != testFewIters; i++ {
+		a := new(G1Affine).FromProjective(new(G1).Random())
+		b := new(G2Affine).FromProjective(new(G2).Random())
+		bp := new(G2Prepared).Prepare(b)
+		aneg := new(G1Affine).Negate(a)
+
+		if !PairingCheck([]*G1Affine{a, aneg}, []*G2Affine{b, b}, nil, nil) {
+			t.Fatal("Pairing check rejected a valid equation")
+		}
+		if !PairingCheck([]*G1Affine{a}, []*G2Affine{b}, []*G1Affine{aneg}, []*G2Prepared{bp}) {
+			t.Fatal("Pairing check rejected a valid equation")
+		}
+		if PairingCheck([]*G1Affine{a}, []*G2Affine{b}, []*G1Affine{a}, []*G2Prepared{bp}) {
+			t.Fatal("Pairing check accepted an invalid equation")
+		}
+	}
+}
+
 func BenchmarkG1Add(b *testing.B) {
 	b.StopTimer()
 	if testing.Short() {
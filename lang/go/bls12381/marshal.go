@@ -46,7 +46,8 @@ var (
 	G2MarshalledCompressedSize   = int(C.embedded_pairing_bls12_381_g2_marshalled_compressed_size)
 	G2MarshalledUncompressedSize = int(C.embedded_pairing_bls12_381_g2_marshalled_uncompressed_size)
 
-	GTMarshalledSize = int(C.embedded_pairing_bls12_381_gt_marshalled_size)
+	GTMarshalledSize           = int(C.embedded_pairing_bls12_381_gt_marshalled_size)
+	GTMarshalledCompressedSize = int(C.embedded_pairing_bls12_381_gt_marshalled_compressed_size)
 )
 
 // Marshal encodes an element of G1 into the provided byte slice, in either
@@ -137,3 +138,26 @@ func (g *GT) Unmarshal(marshalled []byte) *GT {
 	C.embedded_pairing_bls12_381_gt_unmarshal(&g.Data, unsafe.Pointer(&marshalled[0]))
 	return g
 }
+
+// MarshalCompressed encodes an element of GT into the provided byte slice, in
+// compressed form, and then returns the byte slice. The compressed form is
+// half the size of the form produced by Marshal, but it only works for
+// elements of GT (not arbitrary elements of the underlying field).
+func (g *GT) MarshalCompressed(into []byte) []byte {
+	if len(into) < GTMarshalledCompressedSize {
+		return nil
+	}
+	C.embedded_pairing_bls12_381_gt_marshal_compressed(unsafe.Pointer(&into[0]), &g.Data)
+	return into
+}
+
+// UnmarshalCompressed recovers an element of GT from a byte slice encoding its
+// compressed form. If CHECKED is set to false, then unmarshalling is faster
+// (the check that the result is in GT is skipped), but the function will not
+// detect if the resulting group element is invalid.
+func (g *GT) UnmarshalCompressed(marshalled []byte, checked bool) *GT {
+	if len(marshalled) < GTMarshalledCompressedSize || !C.embedded_pairing_bls12_381_gt_unmarshal_compressed(&g.Data, unsafe.Pointer(&marshalled[0]), C._Bool(checked)) {
+		return nil
+	}
+	return g
+}
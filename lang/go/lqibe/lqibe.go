@@ -105,6 +105,27 @@ func KeyGen(params *Params, msk *MasterKey, id *ID) *SecretKey {
 	return sk
 }
 
+// KeyGenBatch generates secret keys for many IDs at once. It is faster than
+// calling KeyGen for each ID separately.
+func KeyGenBatch(params *Params, msk *MasterKey, ids []*ID) []*SecretKey {
+	if len(ids) == 0 {
+		return nil
+	}
+
+	cids := make([]C.embedded_pairing_lqibe_id_t, len(ids))
+	for i, id := range ids {
+		cids[i] = id.Data
+	}
+	csks := make([]C.embedded_pairing_lqibe_secretkey_t, len(ids))
+	C.embedded_pairing_lqibe_keygen_batch(&csks[0], &msk.Data, &cids[0], C.size_t(len(ids)))
+
+	sks := make([]*SecretKey, len(ids))
+	for i := range sks {
+		sks[i] = &SecretKey{Data: csks[i]}
+	}
+	return sks
+}
+
 // Encrypt fills the specified buffer with a symmetric key and returns a
 // ciphertext encoding the encrypted symmetric key. The symmetric key buffer
 // can be of any length, but the underlying entropy is only 256 bits.
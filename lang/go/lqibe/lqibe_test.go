@@ -56,6 +56,28 @@ func TestEncryptDecrypt(t *testing.T) {
 	}
 }
 
+func TestKeyGenBatch(t *testing.T) {
+	pp, msk := Setup()
+
+	ids := make([]*ID, 40)
+	for i := range ids {
+		ids[i] = new(ID).Hash([]byte{byte(i)})
+	}
+	sks := KeyGenBatch(pp, msk, ids)
+
+	for i, id := range ids {
+		symm1 := make([]byte, 32)
+		c := Encrypt(symm1, pp, id)
+
+		symm2 := make([]byte, 32)
+		Decrypt(c, sks[i], id, symm2)
+
+		if !bytes.Equal(symm1, symm2) {
+			t.Fatal("Original and decrypted symmetric keys differ")
+		}
+	}
+}
+
 func TestBadKey(t *testing.T) {
 	id1bytes := []byte{1, 2, 3}
 	id1 := new(ID).Hash(id1bytes)
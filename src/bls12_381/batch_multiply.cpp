@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "bls12_381/batch_multiply.hpp"
+#include "bls12_381/curve.hpp"
+#include "bls12_381/pairing.hpp"
+#include "bls12_381/wnaf.hpp"
+#include "bls12_381/decomposition.hpp"
+
+namespace embedded_pairing::bls12_381 {
+    /* Sets a = 2a, given the inverse of 2 * a.y. */
+    template <typename Affine, typename BaseField>
+    static inline void affine_double(Affine& a, const BaseField& inverse) {
+        BaseField lambda;
+        BaseField t;
+        lambda.square(a.x);
+        t.multiply2(lambda);
+        lambda.add(lambda, t);
+        lambda.multiply(lambda, inverse);
+
+        BaseField x3;
+        x3.square(lambda);
+        t.multiply2(a.x);
+        x3.subtract(x3, t);
+
+        t.subtract(a.x, x3);
+        t.multiply(t, lambda);
+        t.subtract(t, a.y);
+        a.x.copy(x3);
+        a.y.copy(t);
+    }
+
+    /* Sets a = a + (bx, by), given the inverse of bx - a.x. */
+    template <typename Affine, typename BaseField>
+    static inline void affine_add(Affine& a, const BaseField& bx, const BaseField& by, const BaseField& inverse) {
+        BaseField lambda;
+        lambda.subtract(by, a.y);
+        lambda.multiply(lambda, inverse);
+
+        BaseField x3;
+        x3.square(lambda);
+        x3.subtract(x3, a.x);
+        x3.subtract(x3, bx);
+
+        BaseField t;
+        t.subtract(a.x, x3);
+        t.multiply(t, lambda);
+        t.subtract(t, a.y);
+        a.x.copy(x3);
+        a.y.copy(t);
+    }
+
+    /*
+     * Doubles each of the N points, with one inversion. DENOMINATORS and
+     * INVERSES must each have room for N elements.
+     */
+    template <typename Affine, typename BaseField>
+    static void batch_double(Affine* points, BaseField* denominators, BaseField* inverses, size_t n) {
+        for (size_t i = 0; i != n; i++) {
+            if (points[i].infinity) {
+                denominators[i].copy(BaseField::zero);
+            } else {
+                denominators[i].multiply2(points[i].y);
+            }
+        }
+
+        core::batch_inverse(inverses, denominators, n);
+
+        for (size_t i = 0; i != n; i++) {
+            if (points[i].infinity) {
+                continue;
+            }
+            if (points[i].y.is_zero()) {
+                points[i].copy(Affine::zero);
+                continue;
+            }
+            affine_double(points[i], inverses[i]);
+        }
+    }
+
+    /*
+     * Adds ADDENDS[i] (or, if NEGATE is true, its negation) to each of the N
+     * POINTS, with one inversion. The cases that the addition formula does
+     * not cover (the point at infinity, and adding a point to itself or its
+     * negation) are handled separately.
+     */
+    template <typename Affine, typename BaseField>
+    static void batch_add(Affine* points, const Affine* addends, bool negate, BaseField* denominators, BaseField* inverses, size_t n) {
+        for (size_t i = 0; i != n; i++) {
+            if (points[i].infinity || addends[i].infinity) {
+                denominators[i].copy(BaseField::zero);
+            } else {
+                denominators[i].subtract(addends[i].x, points[i].x);
+            }
+        }
+
+        core::batch_inverse(inverses, denominators, n);
+
+        for (size_t i = 0; i != n; i++) {
+            const Affine& b = addends[i];
+            if (b.infinity) {
+                continue;
+            }
+
+            BaseField by;
+            if (negate) {
+                by.negate(b.y);
+            } else {
+                by.copy(b.y);
+            }
+
+            if (points[i].infinity) {
+                points[i].x.copy(b.x);
+                points[i].y.copy(by);
+                points[i].infinity = false;
+            } else if (!BaseField::equal(points[i].x, b.x)) {
+                affine_add(points[i], b.x, by, inverses[i]);
+            } else if (!BaseField::equal(points[i].y, by) || points[i].y.is_zero()) {
+                points[i].copy(Affine::zero);
+            } else {
+                BaseField inverse;
+                inverse.multiply2(points[i].y);
+                inverse.inverse(inverse);
+                affine_double(points[i], inverse);
+            }
+        }
+    }
+
+    /*
+     * Storage for multiplying up to CHUNK_SIZE bases by the same scalar. The
+     * scalar is split into COMPONENTS parts, each of which multiplies a
+     * different multiple of the base (via the endomorphism in G1, or the
+     * Frobenius map in G2), and each part is recoded in w-NAF form with the
+     * given WINDOW.
+     *
+     * The tables are built in affine coordinates for all of the bases
+     * together, so each step of building them costs only one inversion.
+     * That lets the main loop use mixed additions, which are much cheaper
+     * than the projective additions in G1::multiply and G2::multiply. The
+     * accumulators themselves stay projective: an inversion costs over a
+     * hundred multiplications, and affine doubling is no cheaper than
+     * projective doubling, so sharing an inversion per doubling does not
+     * pay off unless the chunks are very large.
+     */
+    template <typename Group>
+    struct BatchMultiplyChunk {
+        typedef typename Group::ProjectiveType Projective;
+        typedef typename Group::AffineType Affine;
+        typedef typename Affine::BaseFieldType BaseField;
+        static constexpr unsigned int components = Group::components;
+        static constexpr unsigned int window = Group::window;
+        static constexpr unsigned int chunk_size = Group::chunk_size;
+        static constexpr unsigned int table_size = 1 << (window - 1);
+
+        /*
+         * table[j][k][i] is 2k + 1 times component j of base i. Keeping the
+         * bases innermost means that the entries computed in each step of
+         * building the table are contiguous.
+         */
+        Affine table[components][table_size][chunk_size];
+        BaseField inverses[chunk_size];
+        BaseField scratch[chunk_size];
+
+        /* Fills in the table, given the bases in table[0][0]. */
+        void fill_table(const bool* negate, size_t n) {
+            if constexpr(table_size != 1) {
+                Affine twice[chunk_size];
+                for (size_t i = 0; i != n; i++) {
+                    twice[i].copy(this->table[0][0][i]);
+                }
+                batch_double(twice, this->scratch, this->inverses, n);
+                for (unsigned int k = 1; k != table_size; k++) {
+                    for (size_t i = 0; i != n; i++) {
+                        this->table[0][k][i].copy(this->table[0][k - 1][i]);
+                    }
+                    batch_add(this->table[0][k], twice, false, this->scratch, this->inverses, n);
+                }
+            }
+
+            for (unsigned int k = 0; k != table_size; k++) {
+                for (size_t i = 0; i != n; i++) {
+                    Affine parts[components];
+                    Group::get_components(parts, this->table[0][k][i]);
+                    for (unsigned int j = 0; j != components; j++) {
+                        if (negate[j]) {
+                            this->table[j][k][i].negate(parts[j]);
+                        } else {
+                            this->table[j][k][i].copy(parts[j]);
+                        }
+                    }
+                }
+            }
+        }
+
+        /*
+         * Sets result to the sum over j of digits[j] times component j of
+         * base i.
+         */
+        template <int bits>
+        void multiply(Projective& result, const WnafScalar<bits, window>* digits, int top, size_t i) const {
+            result.copy(Projective::zero);
+            bool found_one = false;
+            for (int b = top - 1; b != -1; b--) {
+                if (found_one) {
+                    result.multiply2(result);
+                }
+                for (unsigned int j = 0; j != components; j++) {
+                    if (b >= digits[j].wnaf_size || digits[j].wnaf[b] == 0) {
+                        continue;
+                    }
+                    int digit = digits[j].wnaf[b];
+                    if (digit > 0) {
+                        result.add(result, this->table[j][digit >> 1][i]);
+                    } else {
+                        Affine negated;
+                        negated.negate(this->table[j][(-digit) >> 1][i]);
+                        result.add(result, negated);
+                    }
+                    found_one = true;
+                }
+            }
+        }
+    };
+
+    /*
+     * In G1, the scalar is split into two parts of about 128 bits using the
+     * endomorphism, as in G1::multiply_endomorphism.
+     */
+    struct G1BatchMultiply {
+        typedef G1 ProjectiveType;
+        typedef G1Affine AffineType;
+        static constexpr unsigned int components = 2;
+        static constexpr int bits = 256;
+
+        /*
+         * Building the tables takes an inversion per entry, so for only a
+         * few bases, G1::multiply is faster.
+         */
+        static constexpr size_t separate_max_bases = 4;
+#if defined(__ARM_ARCH_6M__)
+        static constexpr unsigned int window = 2;
+        static constexpr unsigned int chunk_size = 4;
+#else
+        static constexpr unsigned int window = 4;
+        static constexpr unsigned int chunk_size = 32;
+#endif
+
+        static void decompose(WnafScalar<bits, window>* digits, bool* negate, const BigInt<256>& scalar) {
+            BigInt<256> c[components];
+            G1::decompose_endomorphism(c[0], negate[0], c[1], negate[1], scalar);
+            for (unsigned int j = 0; j != components; j++) {
+                digits[j].from_bigint(c[j]);
+            }
+        }
+
+        static void get_components(G1Affine* result, const G1Affine& base) {
+            result[0].copy(base);
+            if (base.infinity) {
+                result[1].copy(G1Affine::zero);
+                return;
+            }
+            G1 projective;
+            projective.from_affine(base);
+            projective.endomorphism(projective);
+            result[1].x.copy(projective.x);
+            result[1].y.copy(projective.y);
+            result[1].infinity = false;
+        }
+    };
+
+    /*
+     * In G2, the scalar is split into four parts of about 64 bits using the
+     * Frobenius map, as in G2::multiply_frobenius.
+     */
+    struct G2BatchMultiply {
+        typedef G2 ProjectiveType;
+        typedef G2Affine AffineType;
+        static constexpr unsigned int components = 4;
+        static constexpr int bits = 64;
+        static constexpr size_t separate_max_bases = 0;
+#if defined(__ARM_ARCH_6M__)
+        static constexpr unsigned int window = 2;
+        static constexpr unsigned int chunk_size = 2;
+#else
+        static constexpr unsigned int window = 3;
+        static constexpr unsigned int chunk_size = 16;
+#endif
+
+        static void decompose(WnafScalar<bits, window>* digits, bool* negate, const BigInt<256>& scalar) {
+            PowersOfX decomposed;
+            decomposed.decompose(scalar);
+            for (unsigned int j = 0; j != components; j++) {
+                digits[j].from_bigint(decomposed.c[j]);
+                negate[j] = (((j & 0x1) == 0) != bls_x_is_negative);
+            }
+        }
+
+        static void get_components(G2Affine* result, const G2Affine& base) {
+            result[0].copy(base);
+            if (base.infinity) {
+                for (unsigned int j = 1; j != components; j++) {
+                    result[j].copy(G2Affine::zero);
+                }
+                return;
+            }
+
+            /* The Frobenius map keeps z = 1, so the result stays affine. */
+            G2 projective;
+            projective.from_affine(base);
+            for (unsigned int j = 1; j != components; j++) {
+                projective.frobenius_map(projective, 1);
+                result[j].x.copy(projective.x);
+                result[j].y.copy(projective.y);
+                result[j].infinity = false;
+            }
+        }
+    };
+
+    template <typename Affine>
+    static inline void load_affine(Affine* result, const Affine* bases, size_t n) {
+        for (size_t i = 0; i != n; i++) {
+            result[i].copy(bases[i]);
+        }
+    }
+
+    template <typename Affine, typename Projective>
+    static inline void load_affine(Affine* result, const Projective* bases, size_t n) {
+        Affine::batch_from_projective(result, bases, n);
+    }
+
+    template <typename Projective>
+    static inline void store(Projective* results, const Projective* values, size_t n) {
+        for (size_t i = 0; i != n; i++) {
+            results[i].copy(values[i]);
+        }
+    }
+
+    template <typename Affine, typename Projective>
+    static inline void store(Affine* results, const Projective* values, size_t n) {
+        Affine::batch_from_projective(results, values, n);
+    }
+
+    template <typename Group, typename Result, typename Base>
+    static void batch_multiply_impl(Result* results, const Base* bases, size_t n, const BigInt<256>& scalar) {
+        typedef typename Group::ProjectiveType Projective;
+        constexpr unsigned int components = Group::components;
+        constexpr unsigned int chunk_size = Group::chunk_size;
+
+        Projective products[chunk_size];
+        if (n <= Group::separate_max_bases) {
+            for (size_t i = 0; i != n; i++) {
+                products[i].multiply(bases[i], scalar);
+            }
+            store(results, products, n);
+            return;
+        }
+
+        WnafScalar<Group::bits, Group::window> digits[components];
+        bool negate[components];
+        Group::decompose(digits, negate, scalar);
+
+        int top = 0;
+        for (unsigned int j = 0; j != components; j++) {
+            if (digits[j].wnaf_size > top) {
+                top = digits[j].wnaf_size;
+            }
+        }
+
+        BatchMultiplyChunk<Group> chunk;
+        for (size_t start = 0; start < n; start += chunk_size) {
+            size_t count = (n - start < chunk_size) ? (n - start) : chunk_size;
+
+            load_affine(chunk.table[0][0], &bases[start], count);
+            chunk.fill_table(negate, count);
+            for (size_t i = 0; i != count; i++) {
+                chunk.multiply(products[i], digits, top, i);
+            }
+            store(&results[start], products, count);
+        }
+    }
+
+    void batch_multiply(G1* results, const G1* bases, size_t n, const BigInt<256>& scalar) {
+        batch_multiply_impl<G1BatchMultiply>(results, bases, n, scalar);
+    }
+
+    void batch_multiply(G1Affine* results, const G1Affine* bases, size_t n, const BigInt<256>& scalar) {
+        batch_multiply_impl<G1BatchMultiply>(results, bases, n, scalar);
+    }
+
+    void batch_multiply(G2* results, const G2* bases, size_t n, const BigInt<256>& scalar) {
+        batch_multiply_impl<G2BatchMultiply>(results, bases, n, scalar);
+    }
+
+    void batch_multiply(G2Affine* results, const G2Affine* bases, size_t n, const BigInt<256>& scalar) {
+        batch_multiply_impl<G2BatchMultiply>(results, bases, n, scalar);
+    }
+}
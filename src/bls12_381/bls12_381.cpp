@@ -62,6 +62,7 @@ extern "C" {
     const size_t embedded_pairing_bls12_381_g2_marshalled_uncompressed_size = Encoding<G2Affine, false>::size;
 
     const size_t embedded_pairing_bls12_381_gt_marshalled_size = sizeof(Fq12);
+    const size_t embedded_pairing_bls12_381_gt_marshalled_compressed_size = Encoding<Fq12, true>::size;
 }
 
 void embedded_pairing_bls12_381_zp_random(embedded_pairing_core_bigint_256_t* result, void (*get_random_bytes)(void*, size_t)) {
@@ -219,10 +220,22 @@ void embedded_pairing_bls12_381_prepared_pairing(embedded_pairing_bls12_381_fq12
     pairing(*reinterpret_cast<Fq12*>(result), *reinterpret_cast<const G1Affine*>(a), *reinterpret_cast<const G2Prepared*>(b));
 }
 
+void embedded_pairing_bls12_381_pairing_batch(embedded_pairing_bls12_381_fq12_t* results, const embedded_pairing_bls12_381_g1affine_t* a, const embedded_pairing_bls12_381_g2affine_t* b, size_t n) {
+    pairing_batch(reinterpret_cast<Fq12*>(results), reinterpret_cast<const G1Affine*>(a), reinterpret_cast<const G2Affine*>(b), n);
+}
+
 void embedded_pairing_bls12_381_pairing_sum(embedded_pairing_bls12_381_fq12_t* result, embedded_pairing_bls12_381_affine_pair_t* affine_pairs, size_t num_affine_pairs, embedded_pairing_bls12_381_prepared_pair_t* prepared_pairs, size_t num_prepared_pairs) {
     pairing_product(*reinterpret_cast<Fq12*>(result), reinterpret_cast<AffinePair*>(affine_pairs), num_affine_pairs, reinterpret_cast<PreparedPair*>(prepared_pairs), num_prepared_pairs);
 }
 
+void embedded_pairing_bls12_381_pairing_sum_parallel(embedded_pairing_bls12_381_fq12_t* result, embedded_pairing_bls12_381_affine_pair_t* affine_pairs, size_t num_affine_pairs, embedded_pairing_bls12_381_prepared_pair_t* prepared_pairs, size_t num_prepared_pairs, size_t num_tasks, embedded_pairing_bls12_381_parallel_for_t parallel_for, void* executor) {
+    pairing_product_parallel(*reinterpret_cast<Fq12*>(result), reinterpret_cast<AffinePair*>(affine_pairs), num_affine_pairs, reinterpret_cast<PreparedPair*>(prepared_pairs), num_prepared_pairs, num_tasks, parallel_for, executor);
+}
+
+bool embedded_pairing_bls12_381_pairing_check(embedded_pairing_bls12_381_affine_pair_t* affine_pairs, size_t num_affine_pairs, embedded_pairing_bls12_381_prepared_pair_t* prepared_pairs, size_t num_prepared_pairs) {
+    return pairing_check(reinterpret_cast<AffinePair*>(affine_pairs), num_affine_pairs, reinterpret_cast<PreparedPair*>(prepared_pairs), num_prepared_pairs);
+}
+
 void embedded_pairing_bls12_381_g1_marshal(void* buffer, const embedded_pairing_bls12_381_g1affine_t* a, bool compressed) {
     if (compressed) {
         Encoding<G1Affine, true>* encoding = static_cast<Encoding<G1Affine, true>*>(buffer);
@@ -270,3 +283,13 @@ void embedded_pairing_bls12_381_gt_marshal(void* buffer, const embedded_pairing_
 void embedded_pairing_bls12_381_gt_unmarshal(embedded_pairing_bls12_381_fq12_t* a, const void* buffer) {
     reinterpret_cast<Fq12*>(a)->read_big_endian(static_cast<const uint8_t*>(buffer));
 }
+
+void embedded_pairing_bls12_381_gt_marshal_compressed(void* buffer, const embedded_pairing_bls12_381_fq12_t* a) {
+    Encoding<Fq12, true>* encoding = static_cast<Encoding<Fq12, true>*>(buffer);
+    encoding->encode(*reinterpret_cast<const Fq12*>(a));
+}
+
+bool embedded_pairing_bls12_381_gt_unmarshal_compressed(embedded_pairing_bls12_381_fq12_t* a, const void* buffer, bool checked) {
+    const Encoding<Fq12, true>* encoding = static_cast<const Encoding<Fq12, true>*>(buffer);
+    return encoding->decode(*reinterpret_cast<Fq12*>(a), checked);
+}
@@ -71,9 +71,16 @@ namespace embedded_pairing::bls12_381 {
     static constexpr Fq g1_endomorphism_beta = {
         {{{.std_words = {0x798a64e8, 0x30f1361b, 0x7ece5a2a, 0xf3b8ddab, 0xc61577f7, 0x16a8ca3a, 0x74fd029b, 0xc26a2ff8, 0x60701c6e, 0x3636b766, 0x241b6160, 0x051ba4ab}}}}
     };
-    static constexpr Fq2 uplusonetotheqminusoneoversix = {
-        {{{{.std_words = {0xb319d465, 0x7089552, 0xb50a8313, 0xc6695f92, 0xd117228f, 0x97e83ccc, 0xb2dc29ee, 0xa35baeca, 0x5daace4d, 0x1ce393ea, 0xb0fb66eb, 0x8f2220f}}}}},
-        {{{{.std_words = {0x4ce5d646, 0xb2f66aad, 0xfc497cec, 0x5842a06b, 0x2599d394, 0xcf4895d4, 0x40a8e8d0, 0xc11b9cba, 0xe5a0de89, 0x2e3813cb, 0x88847faf, 0x110eefda}}}}}
+    /*
+     * (u + 1)^((q - 1) / 2) and (u + 1)^((q - 1) * 2 / 3), the constants for
+     * the y and x coordinates in the Frobenius map. The latter is in Fq.
+     */
+    static constexpr Fq2 uplusonetotheqminusoneovertwo = {
+        {{{{.std_words = {0x5aa30fda, 0x7bcfa7a2, 0x2a927e7c, 0xdc17dec1, 0x6b4ebef1, 0x2f088dd8, 0xda74d4a7, 0xd1ca2087, 0x96cebc1d, 0x2da25966, 0xbbfd87d2, 0xe2b7eed}}}}},
+        {{{{.std_words = {0x5aa30fda, 0x7bcfa7a2, 0x2a927e7c, 0xdc17dec1, 0x6b4ebef1, 0x2f088dd8, 0xda74d4a7, 0xd1ca2087, 0x96cebc1d, 0x2da25966, 0xbbfd87d2, 0xe2b7eed}}}}}
+    };
+    static constexpr Fq uplusonetotheqminusonetimestwooverthree = {
+        {{{.std_words = {0x867545c3, 0x890dc9e4, 0x3285a5d5, 0x2af32253, 0x309b7e2c, 0x50880866, 0x7e881024, 0xa20d1b8c, 0xe2db9068, 0x14e4f04f, 0x1564853a, 0x14e56d3f}}}}
     };
 
     /*
@@ -227,18 +234,18 @@ namespace embedded_pairing::bls12_381 {
                     if (c0_neg) {
                         G1 tmp;
                         tmp.negate(entry);
-                        this->add(*this, tmp);
+                        wt.add_entry(*this, tmp);
                     } else {
-                        this->add(*this, entry);
+                        wt.add_entry(*this, entry);
                     }
                 } else {
                     G1& entry = wt.table[(-wc0.wnaf[i]) >> 1];
                     if (c0_neg) {
-                        this->add(*this, entry);
+                        wt.add_entry(*this, entry);
                     } else {
                         G1 tmp;
                         tmp.negate(entry);
-                        this->add(*this, tmp);
+                        wt.add_entry(*this, tmp);
                     }
                 }
                 found_one = true;
@@ -251,23 +258,25 @@ namespace embedded_pairing::bls12_381 {
                     if (c1_neg) {
                         timeslambda.negate(timeslambda);
                     }
-                    this->add(*this, timeslambda);
+                    wt.add_entry(*this, timeslambda);
                 } else {
                     G1 timeslambda;
                     timeslambda.endomorphism(wt.table[(-wc1.wnaf[i]) >> 1]);
                     if (!c1_neg) {
                         timeslambda.negate(timeslambda);
                     }
-                    this->add(*this, timeslambda);
+                    wt.add_entry(*this, timeslambda);
                 }
                 found_one = true;
             }
         }
     }
 
-    void G1::multiply_endomorphism(const G1& a, const BigInt<256>& scalar) {
-        BigInt<256> c0, c1;
-        bool c0_neg, c1_neg;
+    /*
+     * Decomposes SCALAR into c0 and c1, of about 128 bits each, such that
+     * scalar * P = c0 * P + c1 * endomorphism(P) for all P in G1.
+     */
+    void G1::decompose_endomorphism(BigInt<256>& c0, bool& c0_neg, BigInt<256>& c1, bool& c1_neg, const BigInt<256>& scalar) {
         if (BigInt<256>::compare(scalar, Fr::p_value) == -1) {
             decompose_lambda(c0, c0_neg, c1, c1_neg, scalar);
         } else {
@@ -275,6 +284,12 @@ namespace embedded_pairing::bls12_381 {
             a.subtract(scalar, Fr::p_value);
             decompose_lambda(c0, c0_neg, c1, c1_neg, scalar);
         }
+    }
+
+    void G1::multiply_endomorphism(const G1& a, const BigInt<256>& scalar) {
+        BigInt<256> c0, c1;
+        bool c0_neg, c1_neg;
+        G1::decompose_endomorphism(c0, c0_neg, c1, c1_neg, scalar);
 
         this->multiply_endomorphism(a, c0, c0_neg, c1, c1_neg);
     }
@@ -286,13 +301,6 @@ namespace embedded_pairing::bls12_381 {
         result.c1.copy(t);
     }
 
-    static void fq2_multiply_frobenius(Fq2& result, const Fq2& a, unsigned int power) {
-        result.copy(a);
-        for (unsigned int i = 0; i != power; i++) {
-            result.multiply(result, uplusonetotheqminusoneoversix);
-        }
-    }
-
     void G2::frobenius_map(const G2& a, unsigned int power) {
         switch (power & 0x3) {
         case 0:
@@ -303,10 +311,11 @@ namespace embedded_pairing::bls12_381 {
             this->y.frobenius_map(a.y, 1);
             this->z.frobenius_map(a.z, 1);
 
-            fq2_multiply_frobenius(this->x, this->x, 4);
+            this->x.c0.multiply(this->x.c0, uplusonetotheqminusonetimestwooverthree);
+            this->x.c1.multiply(this->x.c1, uplusonetotheqminusonetimestwooverthree);
             fq2_multiply_by_u(this->x, this->x);
             fq2_multiply_by_u(this->y, this->y);
-            fq2_multiply_frobenius(this->y, this->y, 3);
+            this->y.multiply(this->y, uplusonetotheqminusoneovertwo);
             break;
         case 2:
             // TODO
@@ -337,22 +346,26 @@ namespace embedded_pairing::bls12_381 {
             wb[i].from_bigint(scalar.c[i]);
         }
 
+        /*
+         * Only the first table is computed directly. Since the frobenius map
+         * is an endomorphism, the other tables are obtained by applying it
+         * to the entries of the previous table. This keeps the entries
+         * normalized, so only one inversion is needed for all four tables.
+         */
         WnafTable<G2, wnaf_window_size> wt[4];
-        {
-            G2 t[4];
-            t[0].copy(a);
-            for (unsigned int i = 1; i != 4; i++) {
-                /* Equivalent to t[i].multiply(t[i - 1], Fq::p_value); */
-                t[i].frobenius_map(t[i - 1], 1);
+        wt[0].fill_table(a);
+        for (unsigned int i = 1; i != 4; i++) {
+            for (int k = 0; k != wt[i].table_size; k++) {
+                /* Equivalent to multiply(wt[i - 1].table[k], Fq::p_value); */
+                wt[i].table[k].frobenius_map(wt[i - 1].table[k], 1);
             }
-            for (unsigned int i = 0; i != 4; i++) {
-                if (((i & 0x1) == 0) != bls_x_is_negative) {
-                    t[i].negate(t[i]);
+        }
+        for (unsigned int i = 0; i != 4; i++) {
+            if (((i & 0x1) == 0) != bls_x_is_negative) {
+                for (int k = 0; k != wt[i].table_size; k++) {
+                    wt[i].table[k].negate(wt[i].table[k]);
                 }
             }
-            for (unsigned int i = 0; i != 4; i++) {
-                wt[i].fill_table(t[i]);
-            }
         }
 
         this->copy(G2::zero);
@@ -365,7 +378,7 @@ namespace embedded_pairing::bls12_381 {
                 /*
                  * Functionally, the code we want is:
                  * if (b[j]->bit(i)) {
-                 *     this->add(*this, t[j]);
+                 *     this->add(*this, wt[j].table[0]);
                  *     found_one = true;
                  * }
                  *
@@ -375,11 +388,11 @@ namespace embedded_pairing::bls12_381 {
                 WnafScalar<64, wnaf_window_size>& power = wb[j];
                 if (i < power.wnaf_size && power.wnaf[i] != 0) {
                     if (power.wnaf[i] > 0) {
-                        this->add(*this, wt[j].table[power.wnaf[i] >> 1]);
+                        wt[j].add_entry(*this, wt[j].table[power.wnaf[i] >> 1]);
                     } else {
                         G2 tmp;
                         tmp.negate(wt[j].table[(-power.wnaf[i]) >> 1]);
-                        this->add(*this, tmp);
+                        wt[j].add_entry(*this, tmp);
                     }
                     found_one = true;
                 }
@@ -37,6 +37,8 @@
 
 #include <stddef.h>
 
+using embedded_pairing::core::exponentiate_fixed;
+
 namespace embedded_pairing::bls12_381 {
     /* Constants for instantiating the Fp class template for Fq. */
     extern constexpr BigInt<fq_bits> fq_modulus_var = fq_modulus;
@@ -47,8 +49,49 @@ namespace embedded_pairing::bls12_381 {
     /* The constant ((q - 3) // 4) + 1, used for computing the square root. */
     static constexpr BigInt<fq_bits> fq_qminusthreeoverfourplusone = {.std_words = { 0xffffeaab, 0xee7fbfff, 0xac54ffff, 0x7aaffff, 0x3dac3d89, 0xd9cc34a8, 0x3ce144af, 0xd91dd2e1, 0x90d2eb35, 0x92c6e9ed, 0x8e5ff9a6, 0x680447a }};
 
+    /* The constant (q - 1) // 2, used for computing the Legendre symbol. */
+    static constexpr BigInt<fq_bits> fq_qminusoneovertwo = {.std_words = { 0xffffd555, 0xdcff7fff, 0x58a9ffff, 0xf55ffff, 0x7b587b12, 0xb3986950, 0x79c2895f, 0xb23ba5c2, 0x21a5d66b, 0x258dd3db, 0x1cbff34d, 0xd0088f5 }};
+
+    /*
+     * Window size for exponentiating by the above constants. Both have 229
+     * one bits out of about 380, so a window of 5 bits brings the number of
+     * multiplications down from 229 to about 80.
+     */
+    static constexpr int fq_exponent_window = 5;
+
+    int Fq::legendre(void) const {
+        Fq tmp;
+        exponentiate_fixed<fq_exponent_window>(tmp, *this, fq_qminusoneovertwo);
+
+        if (tmp.is_zero()) {
+            return 0;
+        } else if (tmp.is_one()) {
+            return 1;
+        } else {
+            return -1;
+        }
+    }
+
     void Fq::square_root(const Fq& a) {
-        exponentiate(*this, a, fq_qminusthreeoverfourplusone);
+        exponentiate_fixed<fq_exponent_window>(*this, a, fq_qminusthreeoverfourplusone);
+    }
+
+    /*
+     * Since q = 3 (mod 4), a^((q + 1) / 4) is a square root of a whenever one
+     * exists. So, rather than computing the Legendre symbol first, which
+     * costs as much as the square root, we can compute the candidate and
+     * check it by squaring.
+     */
+    bool Fq::checked_square_root(const Fq& a) {
+        Fq candidate;
+        candidate.square_root(a);
+
+        Fq check;
+        check.square(candidate);
+        bool exists = Fq::equal(check, a);
+
+        this->copy(candidate);
+        return exists;
     }
 
     void Fq::random(void (*get_random_bytes)(void*, size_t)) {
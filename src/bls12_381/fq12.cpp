@@ -190,6 +190,43 @@ namespace embedded_pairing::bls12_381 {
         this->c0.add(this->c0, aa);
     }
 
+    void Fq12::multiply_c014_by_c014(const Fq2& __restrict a0, const Fq2& __restrict a1, const Fq2& __restrict a4, const Fq2& __restrict b0, const Fq2& __restrict b1, const Fq2& __restrict b4) {
+        Fq2 t00;
+        Fq2 t11;
+        Fq2 t44;
+        t00.multiply(a0, b0);
+        t11.multiply(a1, b1);
+        t44.multiply(a4, b4);
+
+        Fq2 sa;
+        Fq2 sb;
+
+        /* Products of the Fq6 parts, (a0 + a1*v) * (b0 + b1*v). */
+        sa.add(a0, a1);
+        sb.add(b0, b1);
+        this->c0.c1.multiply(sa, sb);
+        this->c0.c1.subtract(this->c0.c1, t00);
+        this->c0.c1.subtract(this->c0.c1, t11);
+        this->c0.c2.copy(t11);
+
+        /* Since (v*w)^2 = v^3 = u + 1, a4*b4 goes into the constant term. */
+        this->c0.c0.multiply_by_nonresidue(t44);
+        this->c0.c0.add(this->c0.c0, t00);
+
+        /* Cross terms, (a0 + a1*v) * b4*v*w + (b0 + b1*v) * a4*v*w. */
+        this->c1.c0.copy(Fq2::zero);
+        sa.add(a0, a4);
+        sb.add(b0, b4);
+        this->c1.c1.multiply(sa, sb);
+        this->c1.c1.subtract(this->c1.c1, t00);
+        this->c1.c1.subtract(this->c1.c1, t44);
+        sa.add(a1, a4);
+        sb.add(b1, b4);
+        this->c1.c2.multiply(sa, sb);
+        this->c1.c2.subtract(this->c1.c2, t11);
+        this->c1.c2.subtract(this->c1.c2, t44);
+    }
+
     void Fq12::conjugate(const Fq12& a) {
         this->c0.copy(a.c0);
         this->c1.negate(a.c1);
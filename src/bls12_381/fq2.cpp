@@ -38,14 +38,8 @@ namespace embedded_pairing::bls12_381 {
         {{{{.std_words = {0x2fffd, 0x76090000, 0xc40c0002, 0xebf4000b, 0x53c758ba, 0x5f489857, 0x70525745, 0x77ce5853, 0xa256ec6d, 0x5c071a97, 0xfa80e493, 0x15f65ec3}}}}},
         {{{{.std_words = {0xfffcaaae, 0x43f5ffff, 0xed47fffd, 0x32b7fff2, 0xa2e99d69, 0x7e83a49, 0x8332bb7a, 0xeca8f331, 0xa0f4c069, 0xef148d1e, 0x3eff0206, 0x40ab326}}}}}
     };
-    /* The constant (q - 3) // 4, used for computing the square root. */
-    static constexpr BigInt<fq_bits> fq2_qminusthreeoverfour = {
-        .std_words = {0xffffeaaa, 0xee7fbfff, 0xac54ffff, 0x7aaffff, 0x3dac3d89, 0xd9cc34a8, 0x3ce144af, 0xd91dd2e1, 0x90d2eb35, 0x92c6e9ed, 0x8e5ff9a6, 0x680447a}
-    };
-    /* The constant (q - 1) // 2, used for computing the square root. */
-    static constexpr BigInt<fq_bits> fq2_qminusoneovertwo = {
-        .std_words = {0xffffd555, 0xdcff7fff, 0x58a9ffff, 0xf55ffff, 0x7b587b12, 0xb3986950, 0x79c2895f, 0xb23ba5c2, 0x21a5d66b, 0x258dd3db, 0x1cbff34d, 0xd0088f5}
-    };
+    /* The constant 1/2 in Fq, used for computing the square root. */
+    static constexpr Fq fq2_one_half = {{{{.std_words = {0x15554, 0x18040000, 0x3ab00001, 0x85500005, 0x253c276f, 0x633cb57c, 0x31ebb502, 0x6e22d1ec, 0xf2d14ca2, 0xd3916126, 0x1a006596, 0x17fbb857}}}}};
 
     bool Fq2::is_zero(void) const {
         bool c0_zero = this->c0.is_zero();
@@ -97,18 +91,9 @@ namespace embedded_pairing::bls12_381 {
     }
 
     void Fq2::multiply(const Fq2& a, const Fq2& b) {
-        Fq aa;
-        Fq bb;
-        Fq o;
-        aa.multiply(a.c0, b.c0);
-        bb.multiply(a.c1, b.c1);
-        o.add(b.c0, b.c1);
-
-        this->c1.add(a.c1, a.c0);
-        this->c1.multiply(this->c1, o);
-        this->c1.subtract(this->c1, aa);
-        this->c1.subtract(this->c1, bb);
-        this->c0.subtract(aa, bb);
+        Fq2Double product;
+        product.multiply(a, b);
+        this->montgomery_reduce(product);
     }
 
     void Fq2::square(const Fq2& a) {
@@ -129,6 +114,44 @@ namespace embedded_pairing::bls12_381 {
         this->c1.add(a.c1, t0);
     }
 
+    void Fq2::montgomery_reduce(Fq2Double& __restrict a) {
+        this->c0.montgomery_reduce(a.c0);
+        this->c1.montgomery_reduce(a.c1);
+    }
+
+    void Fq2Double::add(const Fq2Double& a, const Fq2Double& __restrict b) {
+        this->c0.add(a.c0, b.c0);
+        this->c1.add(a.c1, b.c1);
+    }
+
+    void Fq2Double::subtract(const Fq2Double& a, const Fq2Double& __restrict b) {
+        this->c0.subtract(a.c0, b.c0);
+        this->c1.subtract(a.c1, b.c1);
+    }
+
+    void Fq2Double::multiply(const Fq2& a, const Fq2& b) {
+        FqDouble aa;
+        FqDouble bb;
+        Fq sa;
+        Fq sb;
+        aa.multiply(a.c0, b.c0);
+        bb.multiply(a.c1, b.c1);
+        sa.add(a.c0, a.c1);
+        sb.add(b.c0, b.c1);
+
+        this->c1.multiply(sa, sb);
+        this->c1.subtract(this->c1, aa);
+        this->c1.subtract(this->c1, bb);
+        this->c0.subtract(aa, bb);
+    }
+
+    void Fq2Double::multiply_by_nonresidue(const Fq2Double& a) {
+        FqDouble t0;
+        t0.copy(a.c0);
+        this->c0.subtract(a.c0, a.c1);
+        this->c1.add(a.c1, t0);
+    }
+
     void Fq2::norm(Fq& __restrict result) const {
         Fq t;
         result.square(this->c0);
@@ -142,28 +165,70 @@ namespace embedded_pairing::bls12_381 {
         return norm_value.legendre();
     }
 
-    // TODO balance the if statement
     void Fq2::square_root(const Fq2& __restrict a) {
-        if (a.is_zero()) {
-            this->copy(a);
-            return;
+        /* Non-squares are undefined behavior, so ignore the return value. */
+        this->checked_square_root(a);
+    }
+
+    /*
+     * Uses the "complex method" for square roots in Fq[u] / (u^2 + 1)
+     * (Scott, "Implementing cryptographic pairings", Sec. 6.3), which
+     * reduces the problem to two square roots in Fq and an inversion. Since
+     * a is a square in Fq2 if and only if its norm is a square in Fq, the
+     * first square root also tells us whether a square root exists.
+     *
+     * If a is not a square, returns false and leaves this unchanged.
+     */
+    bool Fq2::checked_square_root(const Fq2& a) {
+        Fq t;
+        Fq check;
+
+        Fq root;
+        a.norm(root);
+        if (!root.checked_square_root(root)) {
+            return false;
         }
-        exponentiate(*this, a, fq2_qminusthreeoverfour);
-        Fq2 alpha;
-        alpha.square(*this);
-        alpha.multiply(alpha, a);
-
-        this->multiply(*this, a);
-        if (Fq2::equal(alpha, Fq2::negative_one)) {
-            Fq2 constant = {.c0 = Fq::zero, .c1 = Fq::one};
-            this->multiply(*this, constant);
+
+        /*
+         * If a1 = 0, the norm is a0^2, so gamma = a0 is also a root, and we
+         * use it: that way delta = a0 below is nonzero (unless a = 0), and the
+         * general case yields sqrt(a0) or sqrt(-a0)u, since a1 / 2t = 0.
+         * Both branches do the same work.
+         */
+        Fq gamma;
+        if (a.c1.is_zero()) {
+            gamma.copy(a.c0);
         } else {
-            alpha.add(alpha, Fq2::one);
+            gamma.copy(root);
+        }
+
+        /*
+         * Let delta = (a0 + gamma) / 2 and delta' = (a0 - gamma) / 2. Exactly
+         * one of them is a square, since their product is -a1^2 / 4. If delta
+         * is a square, the root is t + (a1 / 2t)u, where t = sqrt(delta).
+         * Otherwise, t = delta^((q + 1) / 4) satisfies t^2 = -delta, and
+         * sqrt(delta') = a1 / 2t, so the root is (a1 / 2t) + tu.
+         */
+        Fq delta;
+        delta.add(a.c0, gamma);
+        delta.multiply(delta, fq2_one_half);
+        t.square_root(delta);
+        check.square(t);
+        bool delta_is_square = Fq::equal(check, delta);
 
-            Fq2 alphapow;
-            exponentiate(alphapow, alpha, fq2_qminusoneovertwo);
-            this->multiply(*this, alphapow);
+        Fq other;
+        other.multiply2(t);
+        other.inverse(other);
+        other.multiply(other, a.c1);
+
+        if (delta_is_square) {
+            this->c0.copy(t);
+            this->c1.copy(other);
+        } else {
+            this->c0.copy(other);
+            this->c1.copy(t);
         }
+        return true;
     }
 
     void Fq2::random(void (*get_random_bytes)(void*, size_t)) {
@@ -170,39 +170,52 @@ namespace embedded_pairing::bls12_381 {
     }
 
     void Fq6::multiply(const Fq6& a, const Fq6& b) {
-        Fq2 a_a;
-        Fq2 b_b;
-        Fq2 c_c;
+        /*
+         * Each output coefficient is a sum of Fq2 products, so we accumulate
+         * them unreduced and reduce once at the end. This also means that we
+         * only write to this after we are done reading a and b.
+         */
+        Fq2Double a_a;
+        Fq2Double b_b;
+        Fq2Double c_c;
         a_a.multiply(a.c0, b.c0);
         b_b.multiply(a.c1, b.c1);
         c_c.multiply(a.c2, b.c2);
 
         Fq2 tmp1;
         Fq2 tmp2;
-        Fq2 tmp3;
-        tmp1.add(a.c1, a.c2);
-        tmp2.add(a.c0, a.c1);
-        tmp3.add(a.c0, a.c2);
+        Fq2Double acc;
+        Fq2 res0;
+        Fq2 res2;
 
-        this->c0.add(b.c1, b.c2);
-        this->c0.multiply(this->c0, tmp1);
-        this->c0.subtract(this->c0, b_b);
-        this->c0.subtract(this->c0, c_c);
-        this->c0.multiply_by_nonresidue(this->c0);
-        this->c0.add(this->c0, a_a);
-
-        this->c2.add(b.c0, b.c2);
-        this->c2.multiply(this->c2, tmp3);
-        this->c2.subtract(this->c2, a_a);
-        this->c2.add(this->c2, b_b);
-        this->c2.subtract(this->c2, c_c);
-
-        this->c1.add(b.c0, b.c1);
-        this->c1.multiply(this->c1, tmp2);
-        this->c1.subtract(this->c1, a_a);
-        this->c1.subtract(this->c1, b_b);
+        tmp1.add(a.c1, a.c2);
+        tmp2.add(b.c1, b.c2);
+        acc.multiply(tmp1, tmp2);
+        acc.subtract(acc, b_b);
+        acc.subtract(acc, c_c);
+        acc.multiply_by_nonresidue(acc);
+        acc.add(acc, a_a);
+        res0.montgomery_reduce(acc);
+
+        tmp1.add(a.c0, a.c2);
+        tmp2.add(b.c0, b.c2);
+        acc.multiply(tmp1, tmp2);
+        acc.subtract(acc, a_a);
+        acc.add(acc, b_b);
+        acc.subtract(acc, c_c);
+        res2.montgomery_reduce(acc);
+
+        tmp1.add(a.c0, a.c1);
+        tmp2.add(b.c0, b.c1);
+        acc.multiply(tmp1, tmp2);
+        acc.subtract(acc, a_a);
+        acc.subtract(acc, b_b);
         c_c.multiply_by_nonresidue(c_c);
-        this->c1.add(this->c1, c_c);
+        acc.add(acc, c_c);
+        this->c1.montgomery_reduce(acc);
+
+        this->c0.copy(res0);
+        this->c2.copy(res2);
     }
 
     void Fq6::square(const Fq6& a) {
@@ -262,31 +275,39 @@ namespace embedded_pairing::bls12_381 {
     }
 
     void Fq6::multiply_by_c01(const Fq6& a, const Fq2& __restrict c0, const Fq2& __restrict c1) {
-        Fq2 tmp1;
-        Fq2 tmp2;
-        Fq2 tmp3;
-        tmp1.add(a.c1, a.c2);
-        tmp2.add(a.c0, a.c1);
-        tmp3.add(a.c0, a.c2);
-
-        Fq2 a_a;
-        Fq2 b_b;
+        Fq2Double a_a;
+        Fq2Double b_b;
         a_a.multiply(a.c0, c0);
         b_b.multiply(a.c1, c1);
 
-        this->c0.multiply(c1, tmp1);
-        this->c0.subtract(this->c0, b_b);
-        this->c0.multiply_by_nonresidue(this->c0);
-        this->c0.add(this->c0, a_a);
-
-        this->c1.add(c0, c1);
-        this->c1.multiply(this->c1, tmp2);
-        this->c1.subtract(this->c1, a_a);
-        this->c1.subtract(this->c1, b_b);
+        Fq2 tmp1;
+        Fq2 tmp2;
+        Fq2Double acc;
+        Fq2 res0;
+        Fq2 res1;
 
-        this->c2.multiply(c0, tmp3);
-        this->c2.subtract(this->c2, a_a);
-        this->c2.add(this->c2, b_b);
+        tmp1.add(a.c1, a.c2);
+        acc.multiply(c1, tmp1);
+        acc.subtract(acc, b_b);
+        acc.multiply_by_nonresidue(acc);
+        acc.add(acc, a_a);
+        res0.montgomery_reduce(acc);
+
+        tmp1.add(a.c0, a.c1);
+        tmp2.add(c0, c1);
+        acc.multiply(tmp1, tmp2);
+        acc.subtract(acc, a_a);
+        acc.subtract(acc, b_b);
+        res1.montgomery_reduce(acc);
+
+        tmp1.add(a.c0, a.c2);
+        acc.multiply(c0, tmp1);
+        acc.subtract(acc, a_a);
+        acc.add(acc, b_b);
+        this->c2.montgomery_reduce(acc);
+
+        this->c0.copy(res0);
+        this->c1.copy(res1);
     }
 
     void Fq6::random(void (*get_random_bytes)(void*, size_t)) {
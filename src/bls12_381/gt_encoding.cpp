@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bls12_381/fq2.hpp"
+#include "bls12_381/fq6.hpp"
+#include "bls12_381/fq12.hpp"
+#include "bls12_381/pairing.hpp"
+
+namespace embedded_pairing::bls12_381 {
+    /*
+     * Checks if an element of Fq12 is in GT. Membership in the cyclotomic
+     * subgroup is checked as g^(q^4) * g = g^(q^2), and then, for elements of
+     * the cyclotomic subgroup, g is in GT if and only if g^q = g^x (see
+     * Scott, "A note on group membership tests for G1, G2 and GT on BLS
+     * pairing-friendly curves", ePrint 2021/1130). Both checks are always
+     * done, so that the time taken does not depend on which one fails.
+     */
+    static bool is_in_gt(const Fq12& g) {
+        Fq12 t0;
+        Fq12 t1;
+
+        t0.frobenius_map(g, 4);
+        t0.multiply(t0, g);
+        t1.frobenius_map(g, 2);
+        bool cyclotomic = Fq12::equal(t0, t1);
+
+        t0.frobenius_map(g, 1);
+        t1.exponentiate_restrict_cyclotomic_nodiv<BigInt<64>>(g, bls_x);
+        if constexpr(bls_x_is_negative) {
+            t1.conjugate(t1);
+        }
+        bool order = Fq12::equal(t0, t1);
+
+        return cyclotomic & order;
+    }
+
+    template <bool compressed>
+    void Encoding<Fq12, compressed>::encode(const Fq12& g) {
+        if constexpr(compressed) {
+            if (g.c1.is_zero()) {
+                /* This is the identity (-1 is not in GT). */
+                memset(this->data, 0x0, sizeof(this->data));
+                return;
+            }
+
+            /* c = (1 + g.c0) / g.c1 */
+            Fq6 c;
+            Fq6 t;
+            t.inverse(g.c1);
+            c.add(g.c0, Fq6::one);
+            c.multiply(c, t);
+            c.write_big_endian(this->data);
+        } else {
+            g.write_big_endian(this->data);
+        }
+    }
+
+    template <bool compressed>
+    bool Encoding<Fq12, compressed>::decode(Fq12& g, bool checked) const {
+        if constexpr(compressed) {
+            Fq6 c;
+            c.read_big_endian(this->data);
+            if (c.is_zero()) {
+                g.copy(Fq12::one);
+                return true;
+            }
+
+            /*
+             * g = (c + w) / (c - w) = (c + w)^2 / (c^2 - v), since w^2 = v,
+             * so g.c0 = (c^2 + v) / (c^2 - v) and g.c1 = 2c / (c^2 - v). Note
+             * that c^2 - v is never zero, because v is not a square in Fq6.
+             */
+            Fq6 csquared;
+            csquared.square(c);
+            Fq6 den;
+            den.copy(csquared);
+            den.c1.subtract(den.c1, Fq2::one);
+            den.inverse(den);
+            g.c0.copy(csquared);
+            g.c0.c1.add(g.c0.c1, Fq2::one);
+            g.c0.multiply(g.c0, den);
+            g.c1.multiply2(c);
+            g.c1.multiply(g.c1, den);
+
+            if (checked) {
+                return is_in_gt(g);
+            }
+        } else {
+            g.read_big_endian(this->data);
+        }
+        return true;
+    }
+
+    /* Explicitly instantiate Encoding templates. */
+    template struct Encoding<Fq12, false>;
+    template struct Encoding<Fq12, true>;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "bls12_381/multi_scalar.hpp"
+#include "bls12_381/curve.hpp"
+
+namespace embedded_pairing::bls12_381 {
+#if defined(__ARM_ARCH_6M__)
+    /* Keep the stack usage small on embedded platforms. */
+    static constexpr unsigned int straus_chunk_size = 4;
+    static constexpr unsigned int pippenger_max_window = 4;
+#else
+    static constexpr unsigned int straus_chunk_size = 16;
+    static constexpr unsigned int pippenger_max_window = 9;
+#endif
+
+    static constexpr unsigned int scalar_bits = 256;
+    static constexpr unsigned int straus_window = 4;
+
+    /*
+     * Returns the signed (Booth) digit of SCALAR in the window of C bits
+     * starting at bit START. The digit is in [-2^(C - 1), 2^(C - 1)], and
+     * the sum over all windows of digit * 2^START equals the scalar, as long
+     * as the windows extend past the highest set bit. Unlike w-NAF, each
+     * digit depends only on the bits around its window, so we need not store
+     * the recoded scalars.
+     */
+    static inline int booth_digit(const BigInt<256>& scalar, unsigned int start, unsigned int c) {
+        unsigned int v = 0;
+        for (unsigned int j = 0; j != c + 1; j++) {
+            unsigned int position = start + j - 1;
+            if (position < scalar_bits && (start + j) != 0) {
+                v |= ((unsigned int) scalar.bit(position)) << j;
+            }
+        }
+        return (int) ((v >> 1) + (v & 0x1)) - (int) ((v >> c) << c);
+    }
+
+    static inline unsigned int num_windows(unsigned int c) {
+        return scalar_bits / c + 1;
+    }
+
+    template <typename Projective>
+    static inline void to_projective(Projective& result, const Projective& a) {
+        result.copy(a);
+    }
+
+    template <typename Projective, typename Affine>
+    static inline void to_projective(Projective& result, const Affine& a) {
+        result.from_affine(a);
+    }
+
+    /* Sets result = result + digit * base, for a nonzero digit. */
+    template <typename Projective, typename Base>
+    static inline void add_signed(Projective& result, const Base& base, int digit) {
+        if (digit > 0) {
+            result.add(result, base);
+        } else {
+            Base negated;
+            negated.negate(base);
+            result.add(result, negated);
+        }
+    }
+
+    /*
+     * Straus's method for at most straus_chunk_size terms, with a table of
+     * 1, 2, ..., 2^(straus_window - 1) times each base.
+     */
+    template <typename Projective, typename Base>
+    static void straus(Projective& result, const Base* bases, const BigInt<256>* scalars, size_t n) {
+        constexpr unsigned int table_size = 1 << (straus_window - 1);
+        Projective table[straus_chunk_size][table_size];
+        for (size_t i = 0; i != n; i++) {
+            to_projective(table[i][0], bases[i]);
+            table[i][1].multiply2(table[i][0]);
+            for (unsigned int j = 2; j != table_size; j++) {
+                table[i][j].add(table[i][j - 1], bases[i]);
+            }
+        }
+
+        result.copy(Projective::zero);
+        for (int w = num_windows(straus_window) - 1; w != -1; w--) {
+            for (unsigned int j = 0; j != straus_window; j++) {
+                result.multiply2(result);
+            }
+            for (size_t i = 0; i != n; i++) {
+                int digit = booth_digit(scalars[i], w * straus_window, straus_window);
+                if (digit != 0) {
+                    add_signed(result, table[i][(digit > 0 ? digit : -digit) - 1], digit);
+                }
+            }
+        }
+    }
+
+    /*
+     * Pippenger's bucket method with a window of C bits. In each window,
+     * each base is added to (or, for a negative digit, subtracted from) the
+     * bucket for its digit, and then a running sum over the buckets gives
+     * the sum of each bucket times its digit.
+     */
+    template <typename Projective, typename Base>
+    static void pippenger(Projective& result, const Base* bases, const BigInt<256>* scalars, size_t n, unsigned int c) {
+        Projective buckets[1 << (pippenger_max_window - 1)];
+        unsigned int num_buckets = 1 << (c - 1);
+
+        result.copy(Projective::zero);
+        for (int w = num_windows(c) - 1; w != -1; w--) {
+            for (unsigned int j = 0; j != c; j++) {
+                result.multiply2(result);
+            }
+
+            for (unsigned int b = 0; b != num_buckets; b++) {
+                buckets[b].copy(Projective::zero);
+            }
+            for (size_t i = 0; i != n; i++) {
+                int digit = booth_digit(scalars[i], w * c, c);
+                if (digit != 0) {
+                    add_signed(buckets[(digit > 0 ? digit : -digit) - 1], bases[i], digit);
+                }
+            }
+
+            Projective running;
+            Projective window_sum;
+            running.copy(Projective::zero);
+            window_sum.copy(Projective::zero);
+            for (unsigned int b = num_buckets - 1; b != (unsigned int) -1; b--) {
+                running.add(running, buckets[b]);
+                window_sum.add(window_sum, running);
+            }
+            result.add(result, window_sum);
+        }
+    }
+
+    /*
+     * Rough costs, in point additions, counting a doubling as an addition.
+     * Straus pays for the doublings once per chunk, and Pippenger pays for
+     * each of its buckets twice (once to add it to the running sum, and once
+     * to add the running sum to the total) in each window. Straus's
+     * additions are all between projective points, which, empirically, makes
+     * each one about 4/3 as expensive.
+     */
+    static size_t straus_cost(size_t n) {
+        size_t chunks = (n + straus_chunk_size - 1) / straus_chunk_size;
+        size_t cost = n * (num_windows(straus_window) + (1 << (straus_window - 1))) + chunks * scalar_bits;
+        return (cost * 4) / 3;
+    }
+
+    static size_t pippenger_cost(size_t n, unsigned int c) {
+        return num_windows(c) * (n + (((size_t) 1) << c)) + scalar_bits;
+    }
+
+    /*
+     * Up to this many terms, it is faster to multiply each base separately,
+     * since that uses the endomorphism in G1 and the Frobenius map in G2.
+     */
+    static constexpr size_t separate_max_terms = 2;
+
+    template <typename Projective, typename Base>
+    static void multi_scalar_multiply_impl(Projective& result, const Base* bases, const BigInt<256>* scalars, size_t n) {
+        if (n <= separate_max_terms) {
+            Projective term;
+            result.copy(Projective::zero);
+            for (size_t i = 0; i != n; i++) {
+                term.multiply(bases[i], scalars[i]);
+                result.add(result, term);
+            }
+            return;
+        }
+
+        unsigned int best_window = 2;
+        size_t best_cost = pippenger_cost(n, best_window);
+        for (unsigned int c = 3; c <= pippenger_max_window; c++) {
+            size_t cost = pippenger_cost(n, c);
+            if (cost < best_cost) {
+                best_window = c;
+                best_cost = cost;
+            }
+        }
+
+        if (straus_cost(n) <= best_cost) {
+            Projective chunk;
+            result.copy(Projective::zero);
+            for (size_t i = 0; i < n; i += straus_chunk_size) {
+                size_t chunk_size = (n - i < straus_chunk_size) ? (n - i) : straus_chunk_size;
+                straus(chunk, &bases[i], &scalars[i], chunk_size);
+                result.add(result, chunk);
+            }
+        } else {
+            pippenger(result, bases, scalars, n, best_window);
+        }
+    }
+
+    void multi_scalar_multiply(G1& result, const G1Affine* bases, const BigInt<256>* scalars, size_t n) {
+        multi_scalar_multiply_impl(result, bases, scalars, n);
+    }
+
+    void multi_scalar_multiply(G1& result, const G1* bases, const BigInt<256>* scalars, size_t n) {
+        multi_scalar_multiply_impl(result, bases, scalars, n);
+    }
+
+    void multi_scalar_multiply(G2& result, const G2Affine* bases, const BigInt<256>* scalars, size_t n) {
+        multi_scalar_multiply_impl(result, bases, scalars, n);
+    }
+
+    void multi_scalar_multiply(G2& result, const G2* bases, const BigInt<256>* scalars, size_t n) {
+        multi_scalar_multiply_impl(result, bases, scalars, n);
+    }
+}
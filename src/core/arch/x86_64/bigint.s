@@ -322,3 +322,387 @@ embedded_pairing_core_arch_x86_64_fpbase_384_subtract_final_add:
     pop %rbp
     pop %rbx
     ret
+
+.globl embedded_pairing_core_arch_x86_64_fpdouble_384_add
+.type embedded_pairing_core_arch_x86_64_fpdouble_384_add, @function
+.text
+
+# Adds two 768-bit values in [0, p * 2^384) modulo p * 2^384, which amounts to
+# subtracting p from the upper half of the sum if it is at least p.
+# Destination pointer is in rdi
+# Operand 1 pointer is in rsi
+# Operand 2 pointer is in rdx
+# Modulus pointer is in rcx
+embedded_pairing_core_arch_x86_64_fpdouble_384_add:
+    push %rbx
+    push %rbp
+
+    # Lower half is written out directly
+    movq (%rsi), %rax
+    add (%rdx), %rax
+    movq %rax, (%rdi)
+    movq 8(%rsi), %rax
+    adc 8(%rdx), %rax
+    movq %rax, 8(%rdi)
+    movq 16(%rsi), %rax
+    adc 16(%rdx), %rax
+    movq %rax, 16(%rdi)
+    movq 24(%rsi), %rax
+    adc 24(%rdx), %rax
+    movq %rax, 24(%rdi)
+    movq 32(%rsi), %rax
+    adc 32(%rdx), %rax
+    movq %rax, 32(%rdi)
+    movq 40(%rsi), %rax
+    adc 40(%rdx), %rax
+    movq %rax, 40(%rdi)
+
+    # Materialize upper half in [rax, rbx, rbp, r8, r9, rsi] (little endian)
+    movq 48(%rsi), %rax
+    adc 48(%rdx), %rax
+    movq 56(%rsi), %rbx
+    adc 56(%rdx), %rbx
+    movq 64(%rsi), %rbp
+    adc 64(%rdx), %rbp
+    movq 72(%rsi), %r8
+    adc 72(%rdx), %r8
+    movq 80(%rsi), %r9
+    adc 80(%rdx), %r9
+    movq 88(%rsi), %rsi
+    adc 88(%rdx), %rsi
+
+    # Try to decide early
+    movq 40(%rcx), %rdx
+    cmp %rdx, %rsi
+    jb embedded_pairing_core_arch_x86_64_fpdouble_384_add_final_copy
+    je embedded_pairing_core_arch_x86_64_fpdouble_384_add_subtract_compare
+
+embedded_pairing_core_arch_x86_64_fpdouble_384_add_final_subtract:
+    sub (%rcx), %rax
+    movq %rax, 48(%rdi)
+    sbb 8(%rcx), %rbx
+    movq %rbx, 56(%rdi)
+    sbb 16(%rcx), %rbp
+    movq %rbp, 64(%rdi)
+    sbb 24(%rcx), %r8
+    movq %r8, 72(%rdi)
+    sbb 32(%rcx), %r9
+    movq %r9, 80(%rdi)
+    sbb %rdx, %rsi
+    movq %rsi, 88(%rdi)
+
+    pop %rbp
+    pop %rbx
+    ret
+
+embedded_pairing_core_arch_x86_64_fpdouble_384_add_subtract_compare:
+    movq %rax, 48(%rdi)
+    sub (%rcx), %rax
+    movq %rbx, 56(%rdi)
+    sbb 8(%rcx), %rbx
+    movq %rbp, 64(%rdi)
+    sbb 16(%rcx), %rbp
+    movq %r8, 72(%rdi)
+    sbb 24(%rcx), %r8
+    movq %r9, 80(%rdi)
+    sbb 32(%rcx), %r9
+    movq %rsi, 88(%rdi)
+    sbb %rdx, %rsi
+
+    jc embedded_pairing_core_arch_x86_64_fpdouble_384_add_final_return
+
+embedded_pairing_core_arch_x86_64_fpdouble_384_add_final_copy:
+    movq %rax, 48(%rdi)
+    movq %rbx, 56(%rdi)
+    movq %rbp, 64(%rdi)
+    movq %r8, 72(%rdi)
+    movq %r9, 80(%rdi)
+    movq %rsi, 88(%rdi)
+
+embedded_pairing_core_arch_x86_64_fpdouble_384_add_final_return:
+    pop %rbp
+    pop %rbx
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpdouble_384_subtract
+.type embedded_pairing_core_arch_x86_64_fpdouble_384_subtract, @function
+.text
+
+# Subtracts two 768-bit values in [0, p * 2^384) modulo p * 2^384, which
+# amounts to adding p to the upper half of the difference if it borrows.
+# Destination pointer is in rdi
+# Operand 1 pointer is in rsi
+# Operand 2 pointer is in rdx
+# Modulus pointer is in rcx
+embedded_pairing_core_arch_x86_64_fpdouble_384_subtract:
+    push %rbx
+    push %rbp
+
+    # Lower half is written out directly
+    movq (%rsi), %rax
+    sub (%rdx), %rax
+    movq %rax, (%rdi)
+    movq 8(%rsi), %rax
+    sbb 8(%rdx), %rax
+    movq %rax, 8(%rdi)
+    movq 16(%rsi), %rax
+    sbb 16(%rdx), %rax
+    movq %rax, 16(%rdi)
+    movq 24(%rsi), %rax
+    sbb 24(%rdx), %rax
+    movq %rax, 24(%rdi)
+    movq 32(%rsi), %rax
+    sbb 32(%rdx), %rax
+    movq %rax, 32(%rdi)
+    movq 40(%rsi), %rax
+    sbb 40(%rdx), %rax
+    movq %rax, 40(%rdi)
+
+    # Materialize upper half in [rax, rbx, rbp, r8, r9, rsi] (little endian)
+    movq 48(%rsi), %rax
+    sbb 48(%rdx), %rax
+    movq 56(%rsi), %rbx
+    sbb 56(%rdx), %rbx
+    movq 64(%rsi), %rbp
+    sbb 64(%rdx), %rbp
+    movq 72(%rsi), %r8
+    sbb 72(%rdx), %r8
+    movq 80(%rsi), %r9
+    sbb 80(%rdx), %r9
+    movq 88(%rsi), %rsi
+    sbb 88(%rdx), %rsi
+
+    jc embedded_pairing_core_arch_x86_64_fpdouble_384_subtract_final_add
+
+    movq %rax, 48(%rdi)
+    movq %rbx, 56(%rdi)
+    movq %rbp, 64(%rdi)
+    movq %r8, 72(%rdi)
+    movq %r9, 80(%rdi)
+    movq %rsi, 88(%rdi)
+
+    pop %rbp
+    pop %rbx
+    ret
+
+embedded_pairing_core_arch_x86_64_fpdouble_384_subtract_final_add:
+    add (%rcx), %rax
+    movq %rax, 48(%rdi)
+    adc 8(%rcx), %rbx
+    movq %rbx, 56(%rdi)
+    adc 16(%rcx), %rbp
+    movq %rbp, 64(%rdi)
+    adc 24(%rcx), %r8
+    movq %r8, 72(%rdi)
+    adc 32(%rcx), %r9
+    movq %r9, 80(%rdi)
+    adc 40(%rcx), %rsi
+    movq %rsi, 88(%rdi)
+
+    pop %rbp
+    pop %rbx
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bigint_256_add
+.type embedded_pairing_core_arch_x86_64_bigint_256_add, @function
+.text
+
+embedded_pairing_core_arch_x86_64_bigint_256_add:
+    movq (%rsi), %rax
+    add (%rdx), %rax
+    movq %rax, (%rdi)
+
+    addcarry64 8
+    addcarry64 16
+    addcarry64 24
+
+    movq $0, %rax
+    adc %rax, %rax
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bigint_256_subtract
+.type embedded_pairing_core_arch_x86_64_bigint_256_subtract, @function
+.text
+
+embedded_pairing_core_arch_x86_64_bigint_256_subtract:
+    movq (%rsi), %rax
+    sub (%rdx), %rax
+    movq %rax, (%rdi)
+
+    subborrow64 8
+    subborrow64 16
+    subborrow64 24
+
+    sbb %rax, %rax
+    neg %rax
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bigint_256_multiply2
+.type embedded_pairing_core_arch_x86_64_bigint_256_multiply2, @function
+.text
+
+embedded_pairing_core_arch_x86_64_bigint_256_multiply2:
+    movq (%rsi), %rax
+    add %rax, %rax
+    movq %rax, (%rdi)
+
+    mul2carry64 8
+    mul2carry64 16
+    mul2carry64 24
+
+    movq $0, %rax
+    adc %rax, %rax
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_256_multiply2
+.type embedded_pairing_core_arch_x86_64_fpbase_256_multiply2, @function
+.text
+
+# Destination pointer is in rdi
+# Operand 1 pointer is in rsi
+# Modulus pointer is in rdx
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply2:
+    # Materialize sum in [rax, rcx, r8, r9] (little endian)
+    movq (%rsi), %rax
+    add %rax, %rax
+    movq 8(%rsi), %rcx
+    adc %rcx, %rcx
+    movq 16(%rsi), %r8
+    adc %r8, %r8
+    movq 24(%rsi), %r9
+    adc %r9, %r9
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_final_subtract
+
+    # Try to decide early
+    cmp 24(%rdx), %r9
+    jb embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_final_copy
+    jz embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_subtract_compare
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_final_subtract:
+    sub (%rdx), %rax
+    movq %rax, (%rdi)
+    sbb 8(%rdx), %rcx
+    movq %rcx, 8(%rdi)
+    sbb 16(%rdx), %r8
+    movq %r8, 16(%rdi)
+    sbb 24(%rdx), %r9
+    movq %r9, 24(%rdi)
+    ret
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_subtract_compare:
+    movq %rax, (%rdi)
+    sub (%rdx), %rax
+    movq %rcx, 8(%rdi)
+    sbb 8(%rdx), %rcx
+    movq %r8, 16(%rdi)
+    sbb 16(%rdx), %r8
+    movq %r9, 24(%rdi)
+    sbb 24(%rdx), %r9
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_final_copy:
+    movq %rax, (%rdi)
+    movq %rcx, 8(%rdi)
+    movq %r8, 16(%rdi)
+    movq %r9, 24(%rdi)
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply2_final_return:
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_256_add
+.type embedded_pairing_core_arch_x86_64_fpbase_256_add, @function
+.text
+
+# Destination pointer is in rdi
+# Operand 1 pointer is in rsi
+# Operand 2 pointer is in rdx
+# Modulus pointer is in rcx
+embedded_pairing_core_arch_x86_64_fpbase_256_add:
+    # Materialize sum in [rax, r8, r9, r10] (little endian)
+    movq (%rsi), %rax
+    add (%rdx), %rax
+    movq 8(%rsi), %r8
+    adc 8(%rdx), %r8
+    movq 16(%rsi), %r9
+    adc 16(%rdx), %r9
+    movq 24(%rsi), %r10
+    adc 24(%rdx), %r10
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_add_final_subtract
+
+    # Try to decide early
+    cmp 24(%rcx), %r10
+    jb embedded_pairing_core_arch_x86_64_fpbase_256_add_final_copy
+    je embedded_pairing_core_arch_x86_64_fpbase_256_add_subtract_compare
+
+embedded_pairing_core_arch_x86_64_fpbase_256_add_final_subtract:
+    sub (%rcx), %rax
+    movq %rax, (%rdi)
+    sbb 8(%rcx), %r8
+    movq %r8, 8(%rdi)
+    sbb 16(%rcx), %r9
+    movq %r9, 16(%rdi)
+    sbb 24(%rcx), %r10
+    movq %r10, 24(%rdi)
+    ret
+
+embedded_pairing_core_arch_x86_64_fpbase_256_add_subtract_compare:
+    movq %rax, (%rdi)
+    sub (%rcx), %rax
+    movq %r8, 8(%rdi)
+    sbb 8(%rcx), %r8
+    movq %r9, 16(%rdi)
+    sbb 16(%rcx), %r9
+    movq %r10, 24(%rdi)
+    sbb 24(%rcx), %r10
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_add_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_256_add_final_copy:
+    movq %rax, (%rdi)
+    movq %r8, 8(%rdi)
+    movq %r9, 16(%rdi)
+    movq %r10, 24(%rdi)
+
+embedded_pairing_core_arch_x86_64_fpbase_256_add_final_return:
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_256_subtract
+.type embedded_pairing_core_arch_x86_64_fpbase_256_subtract, @function
+.text
+
+# Destination pointer is in rdi
+# Operand 1 pointer is in rsi
+# Operand 2 pointer is in rdx
+# Modulus pointer is in rcx
+embedded_pairing_core_arch_x86_64_fpbase_256_subtract:
+    # Materialize difference in [rax, r8, r9, r10] (little endian)
+    movq (%rsi), %rax
+    sub (%rdx), %rax
+    movq 8(%rsi), %r8
+    sbb 8(%rdx), %r8
+    movq 16(%rsi), %r9
+    sbb 16(%rdx), %r9
+    movq 24(%rsi), %r10
+    sbb 24(%rdx), %r10
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_subtract_final_add
+
+    movq %rax, (%rdi)
+    movq %r8, 8(%rdi)
+    movq %r9, 16(%rdi)
+    movq %r10, 24(%rdi)
+    ret
+
+embedded_pairing_core_arch_x86_64_fpbase_256_subtract_final_add:
+    add (%rcx), %rax
+    movq %rax, (%rdi)
+    adc 8(%rcx), %r8
+    movq %r8, 8(%rdi)
+    adc 16(%rcx), %r9
+    movq %r9, 16(%rdi)
+    adc 24(%rcx), %r10
+    movq %r10, 24(%rdi)
+    ret
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+
+#include "core/bigint.hpp"
+#include "core/fp.hpp"
+
+using embedded_pairing::core::BigInt;
+using embedded_pairing::core::FpBase;
+
+/*
+ * Scalar implementation of the batch interface, for CPUs without AVX-512
+ * IFMA. Each lane is handled by the (assembly-optimized) FpBase<384> code.
+ */
+
+namespace {
+    constexpr int num_lanes = 8;
+    constexpr int num_words = 6;
+
+    typedef uint64_t batch_t[num_words][num_lanes];
+
+    inline void get_lane(FpBase<384>& x, const batch_t& b, int lane) {
+        for (int i = 0; i != num_words; i++) {
+            x.val.words[i] = b[i][lane];
+        }
+    }
+
+    inline void set_lane(batch_t& b, const FpBase<384>& x, int lane) {
+        for (int i = 0; i != num_words; i++) {
+            b[i][lane] = x.val.words[i];
+        }
+    }
+}
+
+extern "C" {
+    void embedded_pairing_core_arch_x86_64_fpbatch_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word) {
+        const BigInt<384>& modulus = *reinterpret_cast<const BigInt<384>*>(p);
+        FpBase<384> x;
+        FpBase<384> y;
+        for (int lane = 0; lane != num_lanes; lane++) {
+            get_lane(x, *reinterpret_cast<const batch_t*>(a), lane);
+            get_lane(y, *reinterpret_cast<const batch_t*>(b), lane);
+            x.multiply(x, y, modulus, inv_word);
+            set_lane(*reinterpret_cast<batch_t*>(res), x, lane);
+        }
+    }
+
+    void embedded_pairing_core_arch_x86_64_fpbatch_384_square(void* res, const void* a, const void* p, uint64_t inv_word) {
+        const BigInt<384>& modulus = *reinterpret_cast<const BigInt<384>*>(p);
+        FpBase<384> x;
+        for (int lane = 0; lane != num_lanes; lane++) {
+            get_lane(x, *reinterpret_cast<const batch_t*>(a), lane);
+            x.square(x, modulus, inv_word);
+            set_lane(*reinterpret_cast<batch_t*>(res), x, lane);
+        }
+    }
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2018, Sam Kumar <samkumar@cs.berkeley.edu>
+ * Copyright (c) 2018, University of California, Berkeley
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Montgomery multiplication of four independent elements at a time, using
+ * AVX2. Each 384-bit element is split into fourteen 29-bit limbs (radix
+ * 2^29), one per 64-bit lane of fourteen vectors, so that vpmuludq can form
+ * 58-bit partial products and whole columns can be summed without carrying.
+ * The batch interface holds eight lanes, so each call processes two groups
+ * of four.
+ *
+ * As in the AVX-512 IFMA implementation, the batch stores elements in the
+ * same Montgomery form as FpBase<384> (i.e., with R = 2^384). The reduction
+ * divides by 2^384 using thirteen 29-bit digits followed by one 7-bit digit,
+ * so results are bit-for-bit identical to those of the scalar code.
+ *
+ * This file is compiled with the target attribute rather than with -mavx2,
+ * so that the rest of the library does not come to depend on AVX2. These
+ * functions must only be called if
+ * embedded_pairing_core_arch_x86_64_cpu_supports_avx2 returns true.
+ */
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#define AVX2 __attribute__((target("avx2")))
+
+/*
+ * The loops below must be fully unrolled so that limb indices are constants
+ * and the compiler can keep vectors in registers.
+ */
+#if defined(__clang__)
+#define UNROLL _Pragma("unroll")
+#else
+#define UNROLL _Pragma("GCC unroll 32")
+#endif
+
+namespace {
+    constexpr int num_lanes = 8;
+    constexpr int num_group_lanes = 4;
+    constexpr int num_words = 6;
+    constexpr int num_limbs = 14;
+    constexpr int limb_bits = 29;
+    constexpr uint64_t limb_mask = (UINT64_C(1) << limb_bits) - 1;
+    constexpr int last_digit_bits = 384 - (num_limbs - 1) * limb_bits;
+    constexpr uint64_t last_digit_mask = (UINT64_C(1) << last_digit_bits) - 1;
+
+    typedef uint64_t batch_t[num_words][num_lanes];
+
+    /*
+     * Splits six 64-bit words into fourteen 29-bit limbs. Shifts by 64 or
+     * more produce zero, so limbs straddling two words need no special case.
+     */
+    AVX2 inline void to_limbs(__m256i* l, const __m256i* w) {
+        const __m256i mask = _mm256_set1_epi64x(limb_mask);
+        UNROLL
+        for (int k = 0; k != num_limbs; k++) {
+            int i = (k * limb_bits) / 64;
+            int shift = (k * limb_bits) % 64;
+            __m256i limb = _mm256_srli_epi64(w[i], shift);
+            if (i != num_words - 1) {
+                limb = _mm256_or_si256(limb, _mm256_slli_epi64(w[i + 1], 64 - shift));
+            }
+            l[k] = _mm256_and_si256(limb, mask);
+        }
+    }
+
+    /* Inverse of to_limbs, for normalized limbs. */
+    AVX2 inline void from_limbs(__m256i* w, const __m256i* l) {
+        UNROLL
+        for (int i = 0; i != num_words; i++) {
+            w[i] = _mm256_setzero_si256();
+        }
+        UNROLL
+        for (int k = 0; k != num_limbs; k++) {
+            int i = (k * limb_bits) / 64;
+            int shift = (k * limb_bits) % 64;
+            w[i] = _mm256_or_si256(w[i], _mm256_slli_epi64(l[k], shift));
+            if (i != num_words - 1 && shift + limb_bits > 64) {
+                w[i + 1] = _mm256_or_si256(w[i + 1], _mm256_srli_epi64(l[k], 64 - shift));
+            }
+        }
+    }
+
+    /* Scalar version of to_limbs, used for the modulus. */
+    inline void to_limbs_scalar(uint64_t* l, const uint64_t* w) {
+        UNROLL
+        for (int k = 0; k != num_limbs; k++) {
+            int i = (k * limb_bits) / 64;
+            int shift = (k * limb_bits) % 64;
+            uint64_t limb = w[i] >> shift;
+            if (i != num_words - 1 && shift != 0) {
+                limb |= w[i + 1] << (64 - shift);
+            }
+            l[k] = limb & limb_mask;
+        }
+    }
+
+    AVX2 inline void load(__m256i* w, const void* batch, int group) {
+        const batch_t& b = *reinterpret_cast<const batch_t*>(batch);
+        UNROLL
+        for (int i = 0; i != num_words; i++) {
+            w[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(&b[i][group * num_group_lanes]));
+        }
+    }
+
+    AVX2 inline void store(void* batch, const __m256i* w, int group) {
+        batch_t& b = *reinterpret_cast<batch_t*>(batch);
+        UNROLL
+        for (int i = 0; i != num_words; i++) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(&b[i][group * num_group_lanes]), w[i]);
+        }
+    }
+
+    /* Broadcasts the limbs of the modulus and the low digit of inv_word. */
+    AVX2 inline void load_modulus(__m256i* p_limbs, __m256i& inv, const void* p, uint64_t inv_word) {
+        uint64_t p_limbs_scalar[num_limbs];
+        to_limbs_scalar(p_limbs_scalar, reinterpret_cast<const uint64_t*>(p));
+        UNROLL
+        for (int j = 0; j != num_limbs; j++) {
+            p_limbs[j] = _mm256_set1_epi64x(p_limbs_scalar[j]);
+        }
+
+        /* inv_word mod 2^29 is -p^-1 mod 2^29, as needed for 29-bit digits. */
+        inv = _mm256_set1_epi64x(inv_word & limb_mask);
+    }
+
+    /*
+     * Computes column k of the Montgomery reduction, given the sum in acc of
+     * the column's partial products and the carry from column k - 1. The
+     * Montgomery digits u[0] to u[13] are produced in columns 0 to 13; the
+     * limbs of the (unshifted) upper half are written to n, starting with
+     * column 13. Each column is the sum of at most 28 products of 29-bit
+     * limbs plus a carry, so it stays below 2^63.
+     */
+    AVX2 inline __m256i reduce_column(__m256i acc, int k, __m256i* u, __m256i* n, const __m256i* p_limbs, __m256i inv) {
+        const __m256i mask = _mm256_set1_epi64x(limb_mask);
+        int first = (k < num_limbs) ? 0 : k - num_limbs + 1;
+        int last = (k < num_limbs) ? k : num_limbs;
+        UNROLL
+        for (int j = first; j != last; j++) {
+            acc = _mm256_add_epi64(acc, _mm256_mul_epu32(u[j], p_limbs[k - j]));
+        }
+        if (k < num_limbs) {
+            /* vpmuludq only uses the low 32 bits of acc; that is enough. */
+            __m256i digit = _mm256_mul_epu32(acc, inv);
+            if (k == num_limbs - 1) {
+                /* 13 * 29 + 7 = 384, so the last digit has only 7 bits. */
+                u[k] = _mm256_and_si256(digit, _mm256_set1_epi64x(last_digit_mask));
+            } else {
+                u[k] = _mm256_and_si256(digit, mask);
+            }
+            acc = _mm256_add_epi64(acc, _mm256_mul_epu32(u[k], p_limbs[0]));
+        }
+        if (k >= num_limbs - 1) {
+            n[k - num_limbs + 1] = _mm256_and_si256(acc, mask);
+        }
+        return _mm256_srli_epi64(acc, limb_bits);
+    }
+
+    /*
+     * Given the upper half n of the reduced product, whose lowest 7 bits are
+     * zero, shifts it right by 7 bits, subtracts p if necessary, and writes
+     * the result, as six 64-bit words, to w.
+     */
+    AVX2 inline void finish(__m256i* w, const __m256i* n, const __m256i* p_limbs) {
+        const __m256i mask = _mm256_set1_epi64x(limb_mask);
+
+        /* The result is less than 2p < 2^382, so n[14] is zero. */
+        __m256i r[num_limbs];
+        UNROLL
+        for (int k = 0; k != num_limbs; k++) {
+            __m256i limb = _mm256_srli_epi64(n[k], last_digit_bits);
+            limb = _mm256_or_si256(limb, _mm256_slli_epi64(n[k + 1], limb_bits - last_digit_bits));
+            r[k] = _mm256_and_si256(limb, mask);
+        }
+
+        /*
+         * Subtract p if r >= p. A borrow makes the 64-bit difference
+         * negative, so it can be read from the top bit.
+         */
+        __m256i d[num_limbs];
+        __m256i borrow = _mm256_setzero_si256();
+        UNROLL
+        for (int k = 0; k != num_limbs; k++) {
+            __m256i diff = _mm256_sub_epi64(_mm256_sub_epi64(r[k], p_limbs[k]), borrow);
+            borrow = _mm256_srli_epi64(diff, 63);
+            d[k] = _mm256_and_si256(diff, mask);
+        }
+        const __m256i keep = _mm256_sub_epi64(_mm256_setzero_si256(), borrow);
+        UNROLL
+        for (int k = 0; k != num_limbs; k++) {
+            d[k] = _mm256_blendv_epi8(d[k], r[k], keep);
+        }
+
+        from_limbs(w, d);
+    }
+
+    /*
+     * The multiplication and the reduction are interleaved column by column
+     * (product scanning), so only a single accumulator is live at a time.
+     */
+    AVX2 inline void multiply_group(void* res, const void* a, const void* b, const void* p, uint64_t inv_word, int group) {
+        __m256i p_limbs[num_limbs];
+        __m256i inv;
+        load_modulus(p_limbs, inv, p, inv_word);
+
+        __m256i w[num_words];
+        __m256i x[num_limbs];
+        __m256i y[num_limbs];
+        load(w, a, group);
+        to_limbs(x, w);
+        load(w, b, group);
+        to_limbs(y, w);
+
+        __m256i u[num_limbs];
+        __m256i n[num_limbs + 1];
+        __m256i carry = _mm256_setzero_si256();
+        UNROLL
+        for (int k = 0; k != 2 * num_limbs; k++) {
+            int first = (k < num_limbs) ? 0 : k - num_limbs + 1;
+            int last = (k < num_limbs) ? k : num_limbs - 1;
+            __m256i acc = carry;
+            UNROLL
+            for (int i = first; i <= last; i++) {
+                acc = _mm256_add_epi64(acc, _mm256_mul_epu32(x[i], y[k - i]));
+            }
+            carry = reduce_column(acc, k, u, n, p_limbs, inv);
+        }
+
+        finish(w, n, p_limbs);
+        store(res, w, group);
+    }
+
+    AVX2 inline void square_group(void* res, const void* a, const void* p, uint64_t inv_word, int group) {
+        __m256i p_limbs[num_limbs];
+        __m256i inv;
+        load_modulus(p_limbs, inv, p, inv_word);
+
+        __m256i w[num_words];
+        __m256i x[num_limbs];
+        __m256i x2[num_limbs];
+        load(w, a, group);
+        to_limbs(x, w);
+
+        /* Doubled limbs have 30 bits, which vpmuludq still handles. */
+        UNROLL
+        for (int i = 0; i != num_limbs; i++) {
+            x2[i] = _mm256_add_epi64(x[i], x[i]);
+        }
+
+        __m256i u[num_limbs];
+        __m256i n[num_limbs + 1];
+        __m256i carry = _mm256_setzero_si256();
+        UNROLL
+        for (int k = 0; k != 2 * num_limbs; k++) {
+            int first = (k < num_limbs) ? 0 : k - num_limbs + 1;
+            int last = (k < num_limbs) ? k : num_limbs - 1;
+            __m256i acc = carry;
+            UNROLL
+            while (first < last) {
+                acc = _mm256_add_epi64(acc, _mm256_mul_epu32(x[first], x2[last]));
+                first++;
+                last--;
+            }
+            if (first == last) {
+                acc = _mm256_add_epi64(acc, _mm256_mul_epu32(x[first], x[first]));
+            }
+            carry = reduce_column(acc, k, u, n, p_limbs, inv);
+        }
+
+        finish(w, n, p_limbs);
+        store(res, w, group);
+    }
+}
+
+extern "C" {
+    AVX2 void embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word) {
+        for (int group = 0; group != num_lanes / num_group_lanes; group++) {
+            multiply_group(res, a, b, p, inv_word, group);
+        }
+    }
+
+    AVX2 void embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_square(void* res, const void* a, const void* p, uint64_t inv_word) {
+        for (int group = 0; group != num_lanes / num_group_lanes; group++) {
+            square_group(res, a, p, inv_word, group);
+        }
+    }
+}
@@ -382,3 +382,386 @@ embedded_pairing_core_arch_x86_64_fpbase_384_montgomery_reduce_final_return:
     pop %rbx
     pop %rbp
     ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_384_multiply
+.type embedded_pairing_core_arch_x86_64_fpbase_384_multiply, @function
+.text
+
+# Interleaved (CIOS) Montgomery multiplication; see the BMI2/ADX version for
+# an explanation of the algorithm. mul clobbers rax and rdx, so the carry
+# between words is kept in rbx and u is kept in r8. inv_word is kept on the
+# stack, at (%rsp).
+
+# Adds src * a[j] and the carry (rbx) to dst, leaving the new carry in rbx.
+.macro ciosmuladdcarry src, j, dst
+    movq \src, %rax
+    mulq (8*\j)(%rsi)
+    add %rax, \dst
+    adc $0, %rdx
+    add %rbx, \dst
+    adc $0, %rdx
+    movq %rdx, %rbx
+.endm
+
+# t0 to t5 contain the running total (t6 is overwritten). b[i] is read from
+# (%rbp) and a is pointed to by rsi.
+.macro cioslowmultiply i, t0, t1, t2, t3, t4, t5, t6
+    movq (8*\i)(%rbp), %rax
+    mulq (%rsi)
+    add %rax, \t0
+    adc $0, %rdx
+    movq %rdx, %rbx
+    ciosmuladdcarry (8*\i)(%rbp), 1, \t1
+    ciosmuladdcarry (8*\i)(%rbp), 2, \t2
+    ciosmuladdcarry (8*\i)(%rbp), 3, \t3
+    ciosmuladdcarry (8*\i)(%rbp), 4, \t4
+    ciosmuladdcarry (8*\i)(%rbp), 5, \t5
+    movq %rbx, \t6
+.endm
+
+# Same as ciosmuladdcarry, but multiplies u (in r8) by p[j] (pointed to by
+# rcx) instead.
+.macro ciosreduceaddcarry j, dst
+    movq %r8, %rax
+    mulq (8*\j)(%rcx)
+    add %rax, \dst
+    adc $0, %rdx
+    add %rbx, \dst
+    adc $0, %rdx
+    movq %rdx, %rbx
+.endm
+
+# Adds u * p to t0 to t6, where u = t0 * inv_word. Afterwards, t0 is zero and
+# t1 to t6 hold the running total shifted right by one word.
+.macro ciosreduce t0, t1, t2, t3, t4, t5, t6
+    movq \t0, %r8
+    imulq (%rsp), %r8
+    movq %r8, %rax
+    mulq (%rcx)
+    add %rax, \t0
+    adc $0, %rdx
+    movq %rdx, %rbx
+    ciosreduceaddcarry 1, \t1
+    ciosreduceaddcarry 2, \t2
+    ciosreduceaddcarry 3, \t3
+    ciosreduceaddcarry 4, \t4
+    ciosreduceaddcarry 5, \t5
+    add %rbx, \t6
+.endm
+
+.macro ciositeration i, t0, t1, t2, t3, t4, t5, t6
+    cioslowmultiply \i, \t0, \t1, \t2, \t3, \t4, \t5, \t6
+    ciosreduce \t0, \t1, \t2, \t3, \t4, \t5, \t6
+.endm
+
+# Result is stored in rdi, first operand is in rsi, second operand is in rdx,
+# prime modulus is in rcx, and inv_word is in r8.
+embedded_pairing_core_arch_x86_64_fpbase_384_multiply:
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r14
+    push %r15
+    push %r8
+
+    movq %rdx, %rbp
+
+    # Registers r9 to r15 store the running total
+    xor %r9, %r9
+    xor %r10, %r10
+    xor %r11, %r11
+    xor %r12, %r12
+    xor %r13, %r13
+    xor %r14, %r14
+
+    ciositeration 0, %r9, %r10, %r11, %r12, %r13, %r14, %r15
+    ciositeration 1, %r10, %r11, %r12, %r13, %r14, %r15, %r9
+    ciositeration 2, %r11, %r12, %r13, %r14, %r15, %r9, %r10
+    ciositeration 3, %r12, %r13, %r14, %r15, %r9, %r10, %r11
+    ciositeration 4, %r13, %r14, %r15, %r9, %r10, %r11, %r12
+    ciositeration 5, %r14, %r15, %r9, %r10, %r11, %r12, %r13
+
+    # Now, result (sans final reduction) is in r15, r9, r10, r11, r12, r13
+
+    # Compare, and branch to either copy or subtraction
+    cmp 40(%rcx), %r13
+    jb embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_copy
+    je embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_subtract_compare
+
+embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_subtract:
+    sub (%rcx), %r15
+    movq %r15, (%rdi)
+    sbb 8(%rcx), %r9
+    movq %r9, 8(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r10, 16(%rdi)
+    sbb 24(%rcx), %r11
+    movq %r11, 24(%rdi)
+    sbb 32(%rcx), %r12
+    movq %r12, 32(%rdi)
+    sbb 40(%rcx), %r13
+    movq %r13, 40(%rdi)
+    jmp embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_subtract_compare:
+    movq %r15, (%rdi)
+    sub (%rcx), %r15
+    movq %r9, 8(%rdi)
+    sbb 8(%rcx), %r9
+    movq %r10, 16(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r11, 24(%rdi)
+    sbb 24(%rcx), %r11
+    movq %r12, 32(%rdi)
+    sbb 32(%rcx), %r12
+    movq %r13, 40(%rdi)
+    sbb 40(%rcx), %r13
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_copy:
+    movq %r15, (%rdi)
+    movq %r9, 8(%rdi)
+    movq %r10, 16(%rdi)
+    movq %r11, 24(%rdi)
+    movq %r12, 32(%rdi)
+    movq %r13, 40(%rdi)
+
+embedded_pairing_core_arch_x86_64_fpbase_384_multiply_final_return:
+
+    pop %r8
+    pop %r15
+    pop %r14
+    pop %r13
+    pop %r12
+    pop %rbx
+    pop %rbp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_384_square
+.type embedded_pairing_core_arch_x86_64_fpbase_384_square, @function
+.text
+
+# Squaring gains more from skipping the products below the diagonal than it
+# does from interleaving, so this computes the full square into a buffer on
+# the stack and then reduces it, without returning to C++ in between.
+# Result is stored in rdi, operand is in rsi, prime modulus is in rdx, and
+# inv_word is in rcx.
+embedded_pairing_core_arch_x86_64_fpbase_384_square:
+    push %rdi
+    push %rdx
+    push %rcx
+    sub $96, %rsp
+
+    movq %rsp, %rdi
+    call embedded_pairing_core_arch_x86_64_bigint_768_square
+
+    movq 112(%rsp), %rdi
+    movq %rsp, %rsi
+    movq 104(%rsp), %rdx
+    movq 96(%rsp), %rcx
+    call embedded_pairing_core_arch_x86_64_fpbase_384_montgomery_reduce
+
+    add $120, %rsp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_256_multiply
+.type embedded_pairing_core_arch_x86_64_fpbase_256_multiply, @function
+.text
+
+# Interleaved (CIOS) Montgomery multiplication for four-word moduli; see the
+# BMI2/ADX version for the requirements on p. Registers are used as in the
+# 384-bit version above, and inv_word is kept on the stack, at (%rsp).
+
+# t0 to t3 contain the running total (t4 is overwritten). b[i] is read from
+# (%rbp) and a is pointed to by rsi.
+.macro cioslowmultiply256 i, t0, t1, t2, t3, t4
+    movq (8*\i)(%rbp), %rax
+    mulq (%rsi)
+    add %rax, \t0
+    adc $0, %rdx
+    movq %rdx, %rbx
+    ciosmuladdcarry (8*\i)(%rbp), 1, \t1
+    ciosmuladdcarry (8*\i)(%rbp), 2, \t2
+    ciosmuladdcarry (8*\i)(%rbp), 3, \t3
+    movq %rbx, \t4
+.endm
+
+# Adds u * p to t0 to t4, where u = t0 * inv_word. Afterwards, t0 is zero and
+# t1 to t4 hold the running total shifted right by one word.
+.macro ciosreduce256 t0, t1, t2, t3, t4
+    movq \t0, %r8
+    imulq (%rsp), %r8
+    movq %r8, %rax
+    mulq (%rcx)
+    add %rax, \t0
+    adc $0, %rdx
+    movq %rdx, %rbx
+    ciosreduceaddcarry 1, \t1
+    ciosreduceaddcarry 2, \t2
+    ciosreduceaddcarry 3, \t3
+    add %rbx, \t4
+.endm
+
+.macro ciositeration256 i, t0, t1, t2, t3, t4
+    cioslowmultiply256 \i, \t0, \t1, \t2, \t3, \t4
+    ciosreduce256 \t0, \t1, \t2, \t3, \t4
+.endm
+
+# Result is stored in rdi, first operand is in rsi, second operand is in rdx,
+# prime modulus is in rcx, and inv_word is in r8.
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply:
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r8
+
+    movq %rdx, %rbp
+
+    # Registers r9 to r13 store the running total
+    xor %r9, %r9
+    xor %r10, %r10
+    xor %r11, %r11
+    xor %r12, %r12
+
+    ciositeration256 0, %r9, %r10, %r11, %r12, %r13
+    ciositeration256 1, %r10, %r11, %r12, %r13, %r9
+    ciositeration256 2, %r11, %r12, %r13, %r9, %r10
+    ciositeration256 3, %r12, %r13, %r9, %r10, %r11
+
+    # Now, result (sans final reduction) is in r13, r9, r10, r11
+
+    # Compare, and branch to either copy or subtraction
+    cmp 24(%rcx), %r11
+    jb embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_copy
+    je embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_subtract_compare
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_subtract:
+    sub (%rcx), %r13
+    movq %r13, (%rdi)
+    sbb 8(%rcx), %r9
+    movq %r9, 8(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r10, 16(%rdi)
+    sbb 24(%rcx), %r11
+    movq %r11, 24(%rdi)
+    jmp embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_subtract_compare:
+    movq %r13, (%rdi)
+    sub (%rcx), %r13
+    movq %r9, 8(%rdi)
+    sbb 8(%rcx), %r9
+    movq %r10, 16(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r11, 24(%rdi)
+    sbb 24(%rcx), %r11
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_copy:
+    movq %r13, (%rdi)
+    movq %r9, 8(%rdi)
+    movq %r10, 16(%rdi)
+    movq %r11, 24(%rdi)
+
+embedded_pairing_core_arch_x86_64_fpbase_256_multiply_final_return:
+    pop %r8
+    pop %r13
+    pop %r12
+    pop %rbx
+    pop %rbp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce
+.type embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce, @function
+.text
+
+# Montgomery reduction of a product a < p * 2^256; see the BMI2/ADX version.
+# Result is stored in rdi, product is in rsi, prime modulus is in rdx, and
+# inv_word is in rcx.
+embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce:
+    push %rbx
+    push %r12
+    push %r13
+    push %rcx
+
+    # The prime modulus is pointed to by rcx
+    movq %rdx, %rcx
+
+    # Registers r9 to r13 store the lower half as it is reduced
+    movq (%rsi), %r9
+    movq 8(%rsi), %r10
+    movq 16(%rsi), %r11
+    movq 24(%rsi), %r12
+    xor %r13, %r13
+
+    ciosreduce256 %r9, %r10, %r11, %r12, %r13
+    ciosreduce256 %r10, %r11, %r12, %r13, %r9
+    ciosreduce256 %r11, %r12, %r13, %r9, %r10
+    ciosreduce256 %r12, %r13, %r9, %r10, %r11
+
+    # Add the upper half of the product
+    add 32(%rsi), %r13
+    adc 40(%rsi), %r9
+    adc 48(%rsi), %r10
+    adc 56(%rsi), %r11
+
+    # Now, result (sans final reduction) is in r13, r9, r10, r11
+
+    # Compare, and branch to either copy or subtraction
+    cmp 24(%rcx), %r11
+    jb embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_copy
+    je embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_subtract_compare
+
+embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_subtract:
+    sub (%rcx), %r13
+    movq %r13, (%rdi)
+    sbb 8(%rcx), %r9
+    movq %r9, 8(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r10, 16(%rdi)
+    sbb 24(%rcx), %r11
+    movq %r11, 24(%rdi)
+    jmp embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_subtract_compare:
+    movq %r13, (%rdi)
+    sub (%rcx), %r13
+    movq %r9, 8(%rdi)
+    sbb 8(%rcx), %r9
+    movq %r10, 16(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r11, 24(%rdi)
+    sbb 24(%rcx), %r11
+
+    jc embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_return
+
+embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_copy:
+    movq %r13, (%rdi)
+    movq %r9, 8(%rdi)
+    movq %r10, 16(%rdi)
+    movq %r11, 24(%rdi)
+
+embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce_final_return:
+    pop %rcx
+    pop %r13
+    pop %r12
+    pop %rbx
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_fpbase_256_square
+.type embedded_pairing_core_arch_x86_64_fpbase_256_square, @function
+.text
+
+# With mulq, a separate squaring pass saves too little at this size to pay for
+# materializing the product, so this is just a multiplication of a by itself.
+# Result is stored in rdi, operand is in rsi, prime modulus is in rdx, and
+# inv_word is in rcx.
+embedded_pairing_core_arch_x86_64_fpbase_256_square:
+    movq %rcx, %r8
+    movq %rdx, %rcx
+    movq %rsi, %rdx
+    jmp embedded_pairing_core_arch_x86_64_fpbase_256_multiply
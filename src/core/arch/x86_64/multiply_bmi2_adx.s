@@ -55,6 +55,80 @@ embedded_pairing_core_arch_x86_64_cpu_supports_bmi2_adx:
     pop %rbx
     ret
 
+.globl embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma
+.type embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma, @function
+.text
+
+embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma:
+    push %rbx
+
+    # The OS must support XSAVE/XGETBV, indicated in bit 27 of ecx
+    movl $0x01, %eax
+    xor %ecx, %ecx
+    cpuid
+    xor %eax, %eax
+    bt $27, %ecx
+    jnc embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma_return
+
+    # The OS must save the SSE, AVX, and AVX-512 (opmask, ZMM_Hi256, and
+    # Hi16_ZMM) state, indicated in bits 1, 2, 5, 6, and 7 of XCR0
+    xor %ecx, %ecx
+    xgetbv
+    andl $0xe6, %eax
+    cmpl $0xe6, %eax
+    movl $0, %eax
+    jne embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma_return
+
+    movl $0x07, %eax
+    xor %ecx, %ecx
+    cpuid
+
+    # AVX512F and AVX512IFMA support are indicated in bits 16 and 21 of ebx
+    xor %eax, %eax
+    andl $0x00210000, %ebx
+    cmpl $0x00210000, %ebx
+    sete %al
+
+embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma_return:
+    pop %rbx
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_cpu_supports_avx2
+.type embedded_pairing_core_arch_x86_64_cpu_supports_avx2, @function
+.text
+
+embedded_pairing_core_arch_x86_64_cpu_supports_avx2:
+    push %rbx
+
+    # The OS must support XSAVE/XGETBV, indicated in bit 27 of ecx
+    movl $0x01, %eax
+    xor %ecx, %ecx
+    cpuid
+    xor %eax, %eax
+    bt $27, %ecx
+    jnc embedded_pairing_core_arch_x86_64_cpu_supports_avx2_return
+
+    # The OS must save the SSE and AVX state, indicated in bits 1 and 2 of XCR0
+    xor %ecx, %ecx
+    xgetbv
+    andl $0x06, %eax
+    cmpl $0x06, %eax
+    movl $0, %eax
+    jne embedded_pairing_core_arch_x86_64_cpu_supports_avx2_return
+
+    movl $0x07, %eax
+    xor %ecx, %ecx
+    cpuid
+
+    # AVX2 support is indicated in bit 5 of ebx
+    xor %eax, %eax
+    bt $5, %ebx
+    adc %eax, %eax
+
+embedded_pairing_core_arch_x86_64_cpu_supports_avx2_return:
+    pop %rbx
+    ret
+
 .globl embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_multiply
 .type embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_multiply, @function
 .text
@@ -378,3 +452,482 @@ embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_montgomery_reduce_final_re
     pop %rbx
     pop %rbp
     ret
+
+.globl embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply
+.type embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply, @function
+.text
+
+# Interleaved (CIOS) Montgomery multiplication. Each iteration adds a * b[i]
+# to the running total and then cancels its least significant word by adding
+# a multiple of p, so the full 768-bit product is never materialized. Because
+# p < 2^381, the running total stays below 2p and fits in seven words (t0 to
+# t6) at every point, so no extra carry word is needed.
+
+# t0 to t5 contain the running total (t6 is zero on entry). b[i] is read
+# from (%rbp), a is pointed to by rsi, and rax and rbx are scratch.
+# At the end, t0 to t6 contain a * b[i] plus the running total.
+.macro cioslowmultiply_bmi2_adx i, t0, t1, t2, t3, t4, t5, t6
+    xor %eax, %eax
+    movq (8*\i)(%rbp), %rdx
+    mulx (%rsi), %rax, %rbx
+    adox %rax, \t0
+    adcx %rbx, \t1
+    mulx 8(%rsi), %rax, %rbx
+    adox %rax, \t1
+    adcx %rbx, \t2
+    mulx 16(%rsi), %rax, %rbx
+    adox %rax, \t2
+    adcx %rbx, \t3
+    mulx 24(%rsi), %rax, %rbx
+    adox %rax, \t3
+    adcx %rbx, \t4
+    mulx 32(%rsi), %rax, %rbx
+    adox %rax, \t4
+    adcx %rbx, \t5
+    mulx 40(%rsi), %rax, %rbx
+    adox %rax, \t5
+    adcx %rbx, \t6
+    movl $0, %eax
+    adox %rax, \t6
+    # Both chains end here, so the carry and overflow flags are both zero
+.endm
+
+# Adds u * p to t0 to t6, where u = t0 * inv_word. inv_word is in r8 and the
+# prime modulus is pointed to by rcx. Afterwards, t0 is zero and t1 to t6
+# hold the running total shifted right by one word.
+.macro ciosreduce_bmi2_adx t0, t1, t2, t3, t4, t5, t6
+    # Clearing the flags here lets this chain start before the previous one
+    # has finished propagating its carries into t6.
+    xor %eax, %eax
+    movq \t0, %rdx
+    mulx %r8, %rdx, %rax
+    mulx (%rcx), %rax, %rbx
+    adox %rax, \t0
+    adcx %rbx, \t1
+    mulx 8(%rcx), %rax, %rbx
+    adox %rax, \t1
+    adcx %rbx, \t2
+    mulx 16(%rcx), %rax, %rbx
+    adox %rax, \t2
+    adcx %rbx, \t3
+    mulx 24(%rcx), %rax, %rbx
+    adox %rax, \t3
+    adcx %rbx, \t4
+    mulx 32(%rcx), %rax, %rbx
+    adox %rax, \t4
+    adcx %rbx, \t5
+    mulx 40(%rcx), %rax, %rbx
+    adox %rax, \t5
+    adcx %rbx, \t6
+    movl $0, %eax
+    adox %rax, \t6
+.endm
+
+.macro ciositeration_bmi2_adx i, t0, t1, t2, t3, t4, t5, t6
+    cioslowmultiply_bmi2_adx \i, \t0, \t1, \t2, \t3, \t4, \t5, \t6
+    ciosreduce_bmi2_adx \t0, \t1, \t2, \t3, \t4, \t5, \t6
+.endm
+
+# Result is stored in rdi, first operand is in rsi, second operand is in rdx,
+# prime modulus is in rcx, and inv_word is in r8.
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply:
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r14
+    push %r15
+
+    # Register rdx is an implicit source to mulx, so b is pointed to by rbp
+    movq %rdx, %rbp
+
+    # Registers r9 to r15 store the running total. xor clears carry and
+    # overflow flags.
+    xor %r9, %r9
+    xor %r10, %r10
+    xor %r11, %r11
+    xor %r12, %r12
+    xor %r13, %r13
+    xor %r14, %r14
+    xor %r15, %r15
+
+    ciositeration_bmi2_adx 0, %r9, %r10, %r11, %r12, %r13, %r14, %r15
+    ciositeration_bmi2_adx 1, %r10, %r11, %r12, %r13, %r14, %r15, %r9
+    ciositeration_bmi2_adx 2, %r11, %r12, %r13, %r14, %r15, %r9, %r10
+    ciositeration_bmi2_adx 3, %r12, %r13, %r14, %r15, %r9, %r10, %r11
+    ciositeration_bmi2_adx 4, %r13, %r14, %r15, %r9, %r10, %r11, %r12
+    ciositeration_bmi2_adx 5, %r14, %r15, %r9, %r10, %r11, %r12, %r13
+
+    # Now, result (sans final reduction) is in r15, r9, r10, r11, r12, r13
+
+    # Compare, and branch to either copy or subtraction
+    cmp 40(%rcx), %r13
+    jb embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_copy
+    je embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_subtract_compare
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_subtract:
+    sub (%rcx), %r15
+    movq %r15, (%rdi)
+    sbb 8(%rcx), %r9
+    movq %r9, 8(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r10, 16(%rdi)
+    sbb 24(%rcx), %r11
+    movq %r11, 24(%rdi)
+    sbb 32(%rcx), %r12
+    movq %r12, 32(%rdi)
+    sbb 40(%rcx), %r13
+    movq %r13, 40(%rdi)
+    jmp embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_subtract_compare:
+    movq %r15, (%rdi)
+    sub (%rcx), %r15
+    movq %r9, 8(%rdi)
+    sbb 8(%rcx), %r9
+    movq %r10, 16(%rdi)
+    sbb 16(%rcx), %r10
+    movq %r11, 24(%rdi)
+    sbb 24(%rcx), %r11
+    movq %r12, 32(%rdi)
+    sbb 32(%rcx), %r12
+    movq %r13, 40(%rdi)
+    sbb 40(%rcx), %r13
+
+    jc embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_copy:
+    movq %r15, (%rdi)
+    movq %r9, 8(%rdi)
+    movq %r10, 16(%rdi)
+    movq %r11, 24(%rdi)
+    movq %r12, 32(%rdi)
+    movq %r13, 40(%rdi)
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply_final_return:
+
+    pop %r15
+    pop %r14
+    pop %r13
+    pop %r12
+    pop %rbx
+    pop %rbp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square
+.type embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square, @function
+.text
+
+# Squaring gains more from skipping the products below the diagonal than it
+# does from interleaving, so this computes the full square into a buffer on
+# the stack and then reduces it, without returning to C++ in between.
+# Result is stored in rdi, operand is in rsi, prime modulus is in rdx, and
+# inv_word is in rcx.
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square:
+    push %rdi
+    push %rdx
+    push %rcx
+    sub $96, %rsp
+
+    movq %rsp, %rdi
+    call embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_square
+
+    movq 112(%rsp), %rdi
+    movq %rsp, %rsi
+    movq 104(%rsp), %rdx
+    movq 96(%rsp), %rcx
+    call embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_montgomery_reduce
+
+    add $120, %rsp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply
+.type embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply, @function
+.text
+
+# Interleaved (CIOS) Montgomery multiplication for four-word moduli; see the
+# 384-bit version above. This requires p < 2^255 (true of the BLS12-381 group
+# order), so that the running total fits in five words (t0 to t4).
+
+# t0 to t3 contain the running total (t4 is zero on entry). b[i] is read
+# from (%r8), a is pointed to by rsi, and rax and rbx are scratch.
+.macro cioslowmultiply256_bmi2_adx i, t0, t1, t2, t3, t4
+    xor %eax, %eax
+    movq (8*\i)(%r8), %rdx
+    mulx (%rsi), %rax, %rbx
+    adox %rax, \t0
+    adcx %rbx, \t1
+    mulx 8(%rsi), %rax, %rbx
+    adox %rax, \t1
+    adcx %rbx, \t2
+    mulx 16(%rsi), %rax, %rbx
+    adox %rax, \t2
+    adcx %rbx, \t3
+    mulx 24(%rsi), %rax, %rbx
+    adox %rax, \t3
+    adcx %rbx, \t4
+    movl $0, %eax
+    adox %rax, \t4
+.endm
+
+# Adds u * p to t0 to t4, where u = t0 * inv_word. inv_word is in rbp and the
+# prime modulus is pointed to by rcx. Afterwards, t0 is zero and t1 to t4
+# hold the running total shifted right by one word.
+.macro ciosreduce256_bmi2_adx t0, t1, t2, t3, t4
+    xor %eax, %eax
+    movq \t0, %rdx
+    mulx %rbp, %rdx, %rax
+    mulx (%rcx), %rax, %rbx
+    adox %rax, \t0
+    adcx %rbx, \t1
+    mulx 8(%rcx), %rax, %rbx
+    adox %rax, \t1
+    adcx %rbx, \t2
+    mulx 16(%rcx), %rax, %rbx
+    adox %rax, \t2
+    adcx %rbx, \t3
+    mulx 24(%rcx), %rax, %rbx
+    adox %rax, \t3
+    adcx %rbx, \t4
+    movl $0, %eax
+    adox %rax, \t4
+.endm
+
+.macro ciositeration256_bmi2_adx i, t0, t1, t2, t3, t4
+    cioslowmultiply256_bmi2_adx \i, \t0, \t1, \t2, \t3, \t4
+    ciosreduce256_bmi2_adx \t0, \t1, \t2, \t3, \t4
+.endm
+
+# Result is stored in rdi, first operand is in rsi, second operand is in rdx,
+# prime modulus is in rcx, and inv_word is in r8.
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply:
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r14
+
+    # Register rdx is an implicit source to mulx, so b is pointed to by r8
+    movq %r8, %rbp
+    movq %rdx, %r8
+
+    # Registers r10 to r14 store the running total
+    xor %r10, %r10
+    xor %r11, %r11
+    xor %r12, %r12
+    xor %r13, %r13
+    xor %r14, %r14
+
+    ciositeration256_bmi2_adx 0, %r10, %r11, %r12, %r13, %r14
+    ciositeration256_bmi2_adx 1, %r11, %r12, %r13, %r14, %r10
+    ciositeration256_bmi2_adx 2, %r12, %r13, %r14, %r10, %r11
+    ciositeration256_bmi2_adx 3, %r13, %r14, %r10, %r11, %r12
+
+    # Now, result (sans final reduction) is in r14, r10, r11, r12
+
+    # Compare, and branch to either copy or subtraction
+    cmp 24(%rcx), %r12
+    jb embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_copy
+    je embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_subtract_compare
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_subtract:
+    sub (%rcx), %r14
+    movq %r14, (%rdi)
+    sbb 8(%rcx), %r10
+    movq %r10, 8(%rdi)
+    sbb 16(%rcx), %r11
+    movq %r11, 16(%rdi)
+    sbb 24(%rcx), %r12
+    movq %r12, 24(%rdi)
+    jmp embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_subtract_compare:
+    movq %r14, (%rdi)
+    sub (%rcx), %r14
+    movq %r10, 8(%rdi)
+    sbb 8(%rcx), %r10
+    movq %r11, 16(%rdi)
+    sbb 16(%rcx), %r11
+    movq %r12, 24(%rdi)
+    sbb 24(%rcx), %r12
+
+    jc embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_return
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_copy:
+    movq %r14, (%rdi)
+    movq %r10, 8(%rdi)
+    movq %r11, 16(%rdi)
+    movq %r12, 24(%rdi)
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply_final_return:
+    pop %r14
+    pop %r13
+    pop %r12
+    pop %rbx
+    pop %rbp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce
+.type embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce, @function
+.text
+
+# Montgomery reduction of a product a < p * 2^256, held in r8 to r15. The
+# lower half is reduced first, which leaves (a_lo + m * p) / 2^256 <= p in four
+# words. Adding the upper half (less than p) gives a value less than 2p, from
+# which p is subtracted if necessary. The squaring routine below jumps into
+# this code once it has computed the square in registers, so both routines
+# must save the same registers.
+# Result is stored in rdi, product is in rsi, prime modulus is in rdx, and
+# inv_word is in rcx.
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce:
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r14
+    push %r15
+
+    # inv_word is kept in rbp and the prime modulus is pointed to by rcx
+    movq %rcx, %rbp
+    movq %rdx, %rcx
+
+    movq (%rsi), %r8
+    movq 8(%rsi), %r9
+    movq 16(%rsi), %r10
+    movq 24(%rsi), %r11
+    movq 32(%rsi), %r12
+    movq 40(%rsi), %r13
+    movq 48(%rsi), %r14
+    movq 56(%rsi), %r15
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_registers:
+    xor %esi, %esi
+
+    ciosreduce256_bmi2_adx %r8, %r9, %r10, %r11, %rsi
+    ciosreduce256_bmi2_adx %r9, %r10, %r11, %rsi, %r8
+    ciosreduce256_bmi2_adx %r10, %r11, %rsi, %r8, %r9
+    ciosreduce256_bmi2_adx %r11, %rsi, %r8, %r9, %r10
+
+    # Add the upper half of the product
+    add %r12, %rsi
+    adc %r13, %r8
+    adc %r14, %r9
+    adc %r15, %r10
+
+    # Now, result (sans final reduction) is in rsi, r8, r9, r10
+
+    # Compare, and branch to either copy or subtraction
+    cmp 24(%rcx), %r10
+    jb embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_copy
+    je embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_subtract_compare
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_subtract:
+    sub (%rcx), %rsi
+    movq %rsi, (%rdi)
+    sbb 8(%rcx), %r8
+    movq %r8, 8(%rdi)
+    sbb 16(%rcx), %r9
+    movq %r9, 16(%rdi)
+    sbb 24(%rcx), %r10
+    movq %r10, 24(%rdi)
+    jmp embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_return
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_subtract_compare:
+    movq %rsi, (%rdi)
+    sub (%rcx), %rsi
+    movq %r8, 8(%rdi)
+    sbb 8(%rcx), %r8
+    movq %r9, 16(%rdi)
+    sbb 16(%rcx), %r9
+    movq %r10, 24(%rdi)
+    sbb 24(%rcx), %r10
+
+    jc embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_return
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_copy:
+    movq %rsi, (%rdi)
+    movq %r8, 8(%rdi)
+    movq %r9, 16(%rdi)
+    movq %r10, 24(%rdi)
+
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_final_return:
+    pop %r15
+    pop %r14
+    pop %r13
+    pop %r12
+    pop %rbx
+    pop %rbp
+    ret
+
+.globl embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square
+.type embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square, @function
+.text
+
+# Computes the square in r8 to r15, skipping the products below the diagonal,
+# and then finishes in the Montgomery reduction routine above.
+# Result is stored in rdi, operand is in rsi, prime modulus is in rdx, and
+# inv_word is in rcx.
+embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square:
+    push %rbp
+    push %rbx
+    push %r12
+    push %r13
+    push %r14
+    push %r15
+
+    # inv_word is kept in rbp and the prime modulus is pointed to by rcx
+    movq %rcx, %rbp
+    movq %rdx, %rcx
+
+    # Products above the diagonal go in r9 to r14
+    xor %r13d, %r13d
+    movq (%rsi), %rdx
+    mulx 8(%rsi), %r9, %r10
+    mulx 16(%rsi), %rax, %r11
+    add %rax, %r10
+    mulx 24(%rsi), %rax, %r12
+    adc %rax, %r11
+    adc $0, %r12
+
+    movq 8(%rsi), %rdx
+    mulx 16(%rsi), %rax, %rbx
+    add %rax, %r11
+    adc %rbx, %r12
+    adc $0, %r13
+    mulx 24(%rsi), %rax, %rbx
+    add %rax, %r12
+    adc %rbx, %r13
+
+    movq 16(%rsi), %rdx
+    mulx 24(%rsi), %rax, %r14
+    add %rax, %r13
+    adc $0, %r14
+
+    # Double them
+    xor %r15d, %r15d
+    add %r9, %r9
+    adc %r10, %r10
+    adc %r11, %r11
+    adc %r12, %r12
+    adc %r13, %r13
+    adc %r14, %r14
+    adc $0, %r15
+
+    # Add the products on the diagonal
+    movq (%rsi), %rdx
+    mulx %rdx, %r8, %rax
+    add %rax, %r9
+    movq 8(%rsi), %rdx
+    mulx %rdx, %rax, %rbx
+    adc %rax, %r10
+    adc %rbx, %r11
+    movq 16(%rsi), %rdx
+    mulx %rdx, %rax, %rbx
+    adc %rax, %r12
+    adc %rbx, %r13
+    movq 24(%rsi), %rdx
+    mulx %rdx, %rax, %rbx
+    adc %rax, %r14
+    adc %rbx, %r15
+
+    jmp embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce_registers
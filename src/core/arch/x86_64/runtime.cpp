@@ -34,20 +34,61 @@
 
 extern "C" {
     bool embedded_pairing_core_arch_x86_64_cpu_supports_bmi2_adx(void);
+    bool embedded_pairing_core_arch_x86_64_cpu_supports_avx2(void);
+    bool embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma(void);
+
+    void embedded_pairing_core_arch_x86_64_fpbase_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+
+    void embedded_pairing_core_arch_x86_64_fpbase_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
 
     void embedded_pairing_core_arch_x86_64_fpbase_384_montgomery_reduce(void* res, void* a, const void* p, uint64_t inv_word);
     void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_montgomery_reduce(void* res, void* a, const void* p, uint64_t inv_word);
 
+    void embedded_pairing_core_arch_x86_64_fpbase_256_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+
+    void embedded_pairing_core_arch_x86_64_fpbase_256_square(void* res, const void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square(void* res, const void* a, const void* p, uint64_t inv_word);
+
+    void embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce(void* res, void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce(void* res, void* a, const void* p, uint64_t inv_word);
+
     void embedded_pairing_core_arch_x86_64_bigint_768_multiply(void* res, const void* a, const void* b);
     void embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_multiply(void* res, const void* a, const void* b);
 
     void embedded_pairing_core_arch_x86_64_bigint_768_square(void* res, const void* a);
     void embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_square(void* res, const void* a);
+
+    void embedded_pairing_core_arch_x86_64_fpbatch_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_avx512ifma_fpbatch_384_multiply(void* res, const void* a, const void* b, const void* p, uint64_t inv_word);
+
+    void embedded_pairing_core_arch_x86_64_fpbatch_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
+    void embedded_pairing_core_arch_x86_64_avx512ifma_fpbatch_384_square(void* res, const void* a, const void* p, uint64_t inv_word);
 }
 
 namespace embedded_pairing::core {
     static bool cpu_supports_bmi2_adx = embedded_pairing_core_arch_x86_64_cpu_supports_bmi2_adx();
+    static bool cpu_supports_avx2 = embedded_pairing_core_arch_x86_64_cpu_supports_avx2();
+    static bool cpu_supports_avx512ifma = embedded_pairing_core_arch_x86_64_cpu_supports_avx512ifma();
+
+    /*
+     * The four-lane AVX2 kernel is slower than the BMI2/ADX scalar multiply,
+     * so batches only use it on CPUs that lack BMI2/ADX.
+     */
+    static bool use_avx2_fpbatch = cpu_supports_avx2 && !cpu_supports_bmi2_adx;
+
+    void (*runtime_fpbase_384_multiply)(void*, const void*, const void*, const void*, uint64_t) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_multiply : embedded_pairing_core_arch_x86_64_fpbase_384_multiply;
+    void (*runtime_fpbase_384_square)(void*, const void*, const void*, uint64_t) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_square : embedded_pairing_core_arch_x86_64_fpbase_384_square;
     void (*runtime_fpbase_384_montgomery_reduce)(void*, void*, const void*, uint64_t) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_384_montgomery_reduce : embedded_pairing_core_arch_x86_64_fpbase_384_montgomery_reduce;
+    void (*runtime_fpbase_256_multiply)(void*, const void*, const void*, const void*, uint64_t) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_multiply : embedded_pairing_core_arch_x86_64_fpbase_256_multiply;
+    void (*runtime_fpbase_256_square)(void*, const void*, const void*, uint64_t) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_square : embedded_pairing_core_arch_x86_64_fpbase_256_square;
+    void (*runtime_fpbase_256_montgomery_reduce)(void*, void*, const void*, uint64_t) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_fpbase_256_montgomery_reduce : embedded_pairing_core_arch_x86_64_fpbase_256_montgomery_reduce;
     void (*runtime_bigint_768_multiply)(void*, const void*, const void*) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_multiply : embedded_pairing_core_arch_x86_64_bigint_768_multiply;
     void (*runtime_bigint_768_square)(void*, const void*) = cpu_supports_bmi2_adx ? embedded_pairing_core_arch_x86_64_bmi2_adx_bigint_768_square : embedded_pairing_core_arch_x86_64_bigint_768_square;
+    void (*runtime_fpbatch_384_multiply)(void*, const void*, const void*, const void*, uint64_t) = cpu_supports_avx512ifma ? embedded_pairing_core_arch_x86_64_avx512ifma_fpbatch_384_multiply : (use_avx2_fpbatch ? embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply : embedded_pairing_core_arch_x86_64_fpbatch_384_multiply);
+    void (*runtime_fpbatch_384_square)(void*, const void*, const void*, uint64_t) = cpu_supports_avx512ifma ? embedded_pairing_core_arch_x86_64_avx512ifma_fpbatch_384_square : (use_avx2_fpbatch ? embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_square : embedded_pairing_core_arch_x86_64_fpbatch_384_square);
  }
@@ -37,6 +37,7 @@
 
 #include "bls12_381/fq.hpp"
 #include "bls12_381/wnaf.hpp"
+#include "bls12_381/batch_multiply.hpp"
 
 namespace embedded_pairing::lqibe {
     void compute_id_from_hash(ID& id, const IDHash& hash) {
@@ -62,6 +63,29 @@ namespace embedded_pairing::lqibe {
         sk.sq.from_projective(sq);
     }
 
+    /*
+     * Generates secret keys for N IDs at once, which is faster than calling
+     * keygen for each one, since all of the keys use the same scalar.
+     */
+    void keygen_batch(SecretKey* sks, const MasterKey& msk, const ID* ids, size_t n) {
+#ifdef __ARM_ARCH_6M__
+        constexpr size_t chunk_size = 4;
+#else
+        constexpr size_t chunk_size = 32;
+#endif
+        G1Affine sq[chunk_size];
+        for (size_t start = 0; start < n; start += chunk_size) {
+            size_t count = (n - start < chunk_size) ? (n - start) : chunk_size;
+            for (size_t i = 0; i != count; i++) {
+                sq[i].copy(ids[start + i].q);
+            }
+            bls12_381::batch_multiply(sq, sq, count, msk.s);
+            for (size_t i = 0; i != count; i++) {
+                sks[start + i].sq.copy(sq[i]);
+            }
+        }
+    }
+
     struct SymmetricKeyHashBuffer {
         bls12_381::Encoding<G1Affine, true> q;
         bls12_381::Encoding<G2Affine, true> rp;
@@ -73,21 +97,21 @@ namespace embedded_pairing::lqibe {
         Scalar r;
         rx.random(r, get_random_bytes);
 
-        G2 rp;
-        rp.multiply_frobenius(params.p, rx);
-        ciphertext.rp.from_projective(rp);
-
-        G2 rsp;
-        rsp.multiply_frobenius(params.sp, rx);
+        /* Compute rp and rsp, and convert both to affine with one inversion. */
+        G2Affine affine[2];
+        {
+            G2 projective[2];
+            projective[0].multiply_frobenius(params.p, rx);
+            projective[1].multiply_frobenius(params.sp, rx);
+            G2Affine::batch_from_projective(affine, projective, 2);
+        }
+        ciphertext.rp.copy(affine[0]);
 
         SymmetricKeyHashBuffer buffer;
 
         {
-            G2Affine rspaffine;
-            rspaffine.from_projective(rsp);
-
             GT result;
-            bls12_381::pairing(result, id.q, rspaffine);
+            bls12_381::pairing(result, id.q, affine[1]);
 
             buffer.q.encode(id.q);
             buffer.rp.encode(ciphertext.rp);
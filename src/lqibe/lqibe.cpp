@@ -50,6 +50,10 @@ void embedded_pairing_lqibe_keygen(embedded_pairing_lqibe_secretkey_t* sk, const
     keygen(*reinterpret_cast<SecretKey*>(sk), *reinterpret_cast<const MasterKey*>(msk), *reinterpret_cast<const ID*>(id));
 }
 
+void embedded_pairing_lqibe_keygen_batch(embedded_pairing_lqibe_secretkey_t* sks, const embedded_pairing_lqibe_masterkey_t* msk, const embedded_pairing_lqibe_id_t* ids, size_t n) {
+    keygen_batch(reinterpret_cast<SecretKey*>(sks), *reinterpret_cast<const MasterKey*>(msk), reinterpret_cast<const ID*>(ids), n);
+}
+
 void embedded_pairing_lqibe_encrypt(embedded_pairing_lqibe_ciphertext_t* ciphertext, void* symmetric, size_t symmetric_length, const embedded_pairing_lqibe_params_t* params, const embedded_pairing_lqibe_id_t* id, void (*hash_fill)(void*, size_t, const void*, size_t), void (*get_random_bytes)(void*, size_t)) {
     encrypt(*reinterpret_cast<Ciphertext*>(ciphertext), symmetric, symmetric_length, *reinterpret_cast<const Params*>(params), *reinterpret_cast<const ID*>(id), hash_fill, get_random_bytes);
 }
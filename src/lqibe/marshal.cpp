@@ -45,13 +45,13 @@ namespace embedded_pairing::lqibe {
     void Params::marshal(void* buffer) const {
         ParamsMarshalled<compressed>* encoded = reinterpret_cast<ParamsMarshalled<compressed>*>(buffer);
 
-        G2Affine paffine;
-        paffine.from_projective(this->p);
-        encoded->p.encode(paffine);
-
-        G2Affine spaffine;
-        spaffine.from_projective(this->sp);
-        encoded->sp.encode(spaffine);
+        G2Affine affine[2];
+        G2 projective[2];
+        projective[0].copy(this->p);
+        projective[1].copy(this->sp);
+        G2Affine::batch_from_projective(affine, projective, 2);
+        encoded->p.encode(affine[0]);
+        encoded->sp.encode(affine[1]);
     }
 
     template <bool compressed>
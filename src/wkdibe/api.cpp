@@ -37,8 +37,50 @@
 #include "bls12_381/pairing.hpp"
 #include "bls12_381/wnaf.hpp"
 #include "bls12_381/decomposition.hpp"
+#include "bls12_381/multi_scalar.hpp"
+#include "bls12_381/batch_multiply.hpp"
 
 namespace embedded_pairing::wkdibe {
+    /*
+     * Adds terms of the form base * scalar to TOTAL. The terms are collected
+     * into chunks and summed with multi_scalar_multiply, which is much faster
+     * than multiplying and adding them one at a time. Call flush() once all
+     * terms are added.
+     */
+    struct MultiScalarSum {
+#ifdef __ARM_ARCH_6M__
+        static constexpr int chunk_size = 4;
+#else
+        static constexpr int chunk_size = 32;
+#endif
+
+        G1& total;
+        G1 bases[chunk_size];
+        Scalar scalars[chunk_size];
+        int count;
+
+        MultiScalarSum(G1& sum) : total(sum), count(0) {
+        }
+
+        void add(const G1& base, const Scalar& scalar) {
+            this->bases[this->count].copy(base);
+            this->scalars[this->count] = scalar;
+            this->count++;
+            if (this->count == chunk_size) {
+                this->flush();
+            }
+        }
+
+        void flush() {
+            if (this->count != 0) {
+                G1 chunk;
+                bls12_381::multi_scalar_multiply(chunk, this->bases, this->scalars, this->count);
+                this->total.add(this->total, chunk);
+                this->count = 0;
+            }
+        }
+    };
+
     void setup(Params& params, MasterKey& msk, int l, bool signatures, void (*get_random_bytes)(void*, size_t)) {
         bls12_381::PowersOfX alphax;
         Scalar alpha;
@@ -67,58 +109,104 @@ namespace embedded_pairing::wkdibe {
         }
     }
 
+    /*
+     * Adds BASE * SCALAR to RESULT, for many pairs of RESULT and BASE with the
+     * same scalar. The multiplications are collected into chunks and done
+     * with batch_multiply, which is faster than doing them one at a time.
+     * Call flush() once all terms are added; until then, the results are not
+     * updated.
+     */
+    struct SameScalarProducts {
+#ifdef __ARM_ARCH_6M__
+        static constexpr int chunk_size = 4;
+#else
+        static constexpr int chunk_size = 32;
+#endif
+
+        const Scalar& scalar;
+        G1 bases[chunk_size];
+        G1* results[chunk_size];
+        int count;
+
+        SameScalarProducts(const Scalar& s) : scalar(s), count(0) {
+        }
+
+        void add(G1& result, const G1& base) {
+            this->bases[this->count].copy(base);
+            this->results[this->count] = &result;
+            this->count++;
+            if (this->count == chunk_size) {
+                this->flush();
+            }
+        }
+
+        void flush() {
+            if (this->count != 0) {
+                bls12_381::batch_multiply(this->bases, this->bases, this->count, this->scalar);
+                for (int i = 0; i != this->count; i++) {
+                    this->results[i]->add(*this->results[i], this->bases[i]);
+                }
+                this->count = 0;
+            }
+        }
+    };
+
     void keygen(SecretKey& sk, const Params& params, const MasterKey& msk, const AttributeList& attrs, void (*get_random_bytes)(void*, size_t)) {
         bls12_381::PowersOfX rx;
         Scalar r;
-        G1 temp;
         random_zpstar(rx, r, get_random_bytes);
         sk.a0.copy(params.g3);
+        MultiScalarSum a0(sk.a0);
+        SameScalarProducts products(r);
         int j = 0; /* Index for writing to qualified.b */
         int k = 0; /* Index for reading from attrs.attrs */
         for (int i = 0; i != params.l; i++) {
             if (k != attrs.length && attrs.attrs[k].idx == i) {
                 if (!attrs.attrs[k].omitFromKeys) {
-                    temp.multiply(params.h[i], attrs.attrs[k].id);
-                    sk.a0.add(sk.a0, temp);
+                    a0.add(params.h[i], attrs.attrs[k].id);
                 }
                 k++;
             } else if (!attrs.omitAllFromKeysUnlessPresent) {
                 sk.b[j].idx = i;
-                sk.b[j].hexp.multiply(params.h[i], r);
+                sk.b[j].hexp.copy(G1::zero);
+                products.add(sk.b[j].hexp, params.h[i]);
                 j++;
             }
         }
+        a0.flush();
         sk.l = j;
         sk.signatures = params.signatures;
+        sk.bsig.copy(G1::zero);
         if (sk.signatures) {
-            sk.bsig.multiply(params.hsig, r);
-        } else {
-            sk.bsig.copy(G1::zero);
+            products.add(sk.bsig, params.hsig);
         }
-        sk.a0.multiply(sk.a0, r);
-        sk.a0.add(sk.a0, msk.g2alpha);
+        G1 a0base;
+        a0base.copy(sk.a0);
+        sk.a0.copy(msk.g2alpha);
+        products.add(sk.a0, a0base);
+        products.flush();
         sk.a1.multiply_frobenius(params.g, rx);
     }
 
     void qualifykey(SecretKey& qualified, const Params& params, const SecretKey& sk, const AttributeList& attrs, void (*get_random_bytes)(void*, size_t)) {
         bls12_381::PowersOfX tx;
         Scalar t;
-        G1 temp;
         G1 product;
         random_zpstar(tx, t, get_random_bytes);
         product.copy(params.g3);
         qualified.a0.copy(sk.a0);
+        MultiScalarSum product_sum(product);
+        MultiScalarSum a0(qualified.a0);
+        SameScalarProducts products(t);
         int j = 0; /* Index for writing to qualified.b */
         int k = 0; /* Index for reading from attrs.attrs */
         int x = 0; /* Index for reading from sk.b */
         for (int i = 0; i != params.l; i++) {
             if (k != attrs.length && attrs.attrs[k].idx == i) {
                 if (!attrs.attrs[k].omitFromKeys) {
-                    temp.multiply(params.h[i], attrs.attrs[k].id);
-                    product.add(product, temp);
+                    product_sum.add(params.h[i], attrs.attrs[k].id);
                     if (x != sk.l && sk.b[x].idx == i) {
-                        temp.multiply(sk.b[x].hexp, attrs.attrs[k].id);
-                        qualified.a0.add(qualified.a0, temp);
+                        a0.add(sk.b[x].hexp, attrs.attrs[k].id);
                         x++;
                     }
                 }
@@ -126,8 +214,8 @@ namespace embedded_pairing::wkdibe {
             } else if (x != sk.l && sk.b[x].idx == i) {
                 if (!attrs.omitAllFromKeysUnlessPresent) {
                     qualified.b[j].idx = i;
-                    qualified.b[j].hexp.multiply(params.h[i], t);
-                    qualified.b[j].hexp.add(qualified.b[j].hexp, sk.b[x].hexp);
+                    qualified.b[j].hexp.copy(sk.b[x].hexp);
+                    products.add(qualified.b[j].hexp, params.h[i]);
                     j++;
                 }
                 x++;
@@ -137,29 +225,30 @@ namespace embedded_pairing::wkdibe {
              * corresponding to it is not provided, so it can't be filled in).
              */
         }
+        product_sum.flush();
+        a0.flush();
         qualified.l = j;
         qualified.signatures = sk.signatures;
         if (qualified.signatures) {
-            qualified.bsig.multiply(params.hsig, t);
-            qualified.bsig.add(qualified.bsig, sk.bsig);
+            qualified.bsig.copy(sk.bsig);
+            products.add(qualified.bsig, params.hsig);
         } else {
             qualified.bsig.copy(G1::zero);
         }
-        product.multiply(product, t);
-        qualified.a0.add(qualified.a0, product);
+        products.add(qualified.a0, product);
+        products.flush();
         qualified.a1.multiply_frobenius(params.g, tx);
         qualified.a1.add(qualified.a1, sk.a1);
     }
 
     void nondelegable_keygen(SecretKey& sk, const Params& params, const MasterKey& msk, const AttributeList& attrs) {
-        G1 temp;
         sk.a0.copy(params.g3);
+        MultiScalarSum a0(sk.a0);
         int j = 0; /* Index for writing to qualified.b */
         int k = 0; /* Index for reading from attrs.attrs */
         for (int i = 0; i != params.l; i++) {
             if (k != attrs.length && !attrs.attrs[k].omitFromKeys && attrs.attrs[k].idx == i) {
-                temp.multiply(params.h[i], attrs.attrs[k].id);
-                sk.a0.add(sk.a0, temp);
+                a0.add(params.h[i], attrs.attrs[k].id);
                 k++;
             } else if (!attrs.omitAllFromKeysUnlessPresent) {
                 sk.b[j].idx = i;
@@ -167,6 +256,7 @@ namespace embedded_pairing::wkdibe {
                 j++;
             }
         }
+        a0.flush();
         sk.l = j;
         sk.signatures = params.signatures;
         if (sk.signatures) {
@@ -179,16 +269,15 @@ namespace embedded_pairing::wkdibe {
     }
 
     void nondelegable_qualifykey(SecretKey& qualified, const Params& params, const SecretKey& sk, const AttributeList& attrs) {
-        G1 temp;
         qualified.a0.copy(sk.a0);
+        MultiScalarSum a0(qualified.a0);
         int j = 0; /* Index for writing to qualified.b */
         int k = 0; /* Index for reading from attrs.attrs */
         int x = 0; /* Index for reading from sk.b */
         for (int i = 0; x != sk.l && i != params.l; i++) {
             if (k != attrs.length && attrs.attrs[k].idx == i) {
                 if (sk.b[x].idx == i && !attrs.attrs[k].omitFromKeys) {
-                    temp.multiply(sk.b[x].hexp, attrs.attrs[k].id);
-                    qualified.a0.add(qualified.a0, temp);
+                    a0.add(sk.b[x].hexp, attrs.attrs[k].id);
                     x++;
                 }
                 k++;
@@ -205,6 +294,7 @@ namespace embedded_pairing::wkdibe {
              * corresponding to it is not provided, so it can't be filled in).
              */
         }
+        a0.flush();
         qualified.l = j;
         qualified.signatures = sk.signatures;
         if (qualified.signatures) {
@@ -216,8 +306,8 @@ namespace embedded_pairing::wkdibe {
     }
 
     void adjust_nondelegable(SecretKey& sk, const SecretKey& parent, const AttributeList& from, const AttributeList& to) {
-        G1 temp;
         Scalar diff;
+        MultiScalarSum a0(sk.a0);
 
         int j = 0;
         int k = 0;
@@ -240,16 +330,13 @@ namespace embedded_pairing::wkdibe {
                         if (diff.subtract(to.attrs[k].id, from.attrs[j].id)) {
                             diff.add(diff, group_order);
                         }
-                        temp.multiply(parent.b[i].hexp, diff);
-                        sk.a0.add(sk.a0, temp);
+                        a0.add(parent.b[i].hexp, diff);
                     }
                 } else if (sub_from) {
                     diff.subtract(group_order, from.attrs[j].id);
-                    temp.multiply(parent.b[i].hexp, diff);
-                    sk.a0.add(sk.a0, temp);
+                    a0.add(parent.b[i].hexp, diff);
                 } else if (add_to) {
-                    temp.multiply(parent.b[i].hexp, to.attrs[k].id);
-                    sk.a0.add(sk.a0, temp);
+                    a0.add(parent.b[i].hexp, to.attrs[k].id);
                 }
             }
 
@@ -259,23 +346,24 @@ namespace embedded_pairing::wkdibe {
                 x++;
             }
         }
+        a0.flush();
 
         sk.l = x;
     }
 
     void precompute(Precomputed& precomputed, const Params& params, const AttributeList& attrs) {
-        G1 temp;
         precomputed.prodexp.copy(params.g3);
+        MultiScalarSum prodexp(precomputed.prodexp);
         for (int i = 0; i != attrs.length; i++) {
             const Attribute& attr = attrs.attrs[i];
-            temp.multiply(params.h[attr.idx], attr.id);
-            precomputed.prodexp.add(precomputed.prodexp, temp);
+            prodexp.add(params.h[attr.idx], attr.id);
         }
+        prodexp.flush();
     }
 
     void adjust_precomputed(Precomputed& precomputed, const Params& params, const AttributeList& from, const AttributeList& to) {
-        G1 temp;
         Scalar diff;
+        MultiScalarSum prodexp(precomputed.prodexp);
 
         int i = 0;
         int j = 0;
@@ -287,68 +375,65 @@ namespace embedded_pairing::wkdibe {
                     if (diff.subtract(to_attr.id, from_attr.id)) {
                         diff.add(diff, group_order);
                     }
-                    temp.multiply(params.h[to_attr.idx], diff);
-                    precomputed.prodexp.add(precomputed.prodexp, temp);
+                    prodexp.add(params.h[to_attr.idx], diff);
                 }
                 i++;
                 j++;
             } else if (from_attr.idx < to_attr.idx) {
                 diff.subtract(group_order, from_attr.id);
-                temp.multiply(params.h[from_attr.idx], diff);
-                precomputed.prodexp.add(precomputed.prodexp, temp);
+                prodexp.add(params.h[from_attr.idx], diff);
                 i++;
             } else {
-                temp.multiply(params.h[to_attr.idx], to_attr.id);
-                precomputed.prodexp.add(precomputed.prodexp, temp);
+                prodexp.add(params.h[to_attr.idx], to_attr.id);
                 j++;
             }
         }
         while (i != from.length) {
             const Attribute& from_attr = from.attrs[i];
             diff.subtract(group_order, from_attr.id);
-            temp.multiply(params.h[from_attr.idx], diff);
-            precomputed.prodexp.add(precomputed.prodexp, temp);
+            prodexp.add(params.h[from_attr.idx], diff);
             i++;
         }
         while (j != to.length) {
             const Attribute& to_attr = to.attrs[j];
-            temp.multiply(params.h[to_attr.idx], to_attr.id);
-            precomputed.prodexp.add(precomputed.prodexp, temp);
+            prodexp.add(params.h[to_attr.idx], to_attr.id);
             j++;
         }
+        prodexp.flush();
     }
 
     void resamplekey(SecretKey& resampled, const Params& params, const Precomputed& precomputed, const SecretKey& sk, bool supportFurtherQualification, void (*get_random_bytes)(void*, size_t)) {
         bls12_381::PowersOfX tx;
         Scalar t;
-        G1 temp;
         G2 temp2;
         random_zpstar(tx, t, get_random_bytes);
 
-        temp.multiply(precomputed.prodexp, t);
-        resampled.a0.add(sk.a0, temp);
+        SameScalarProducts products(t);
+        resampled.a0.copy(sk.a0);
+        products.add(resampled.a0, precomputed.prodexp);
 
         temp2.multiply_frobenius(params.g, tx);
         resampled.a1.add(sk.a1, temp2);
 
         resampled.signatures = sk.signatures;
         if (resampled.signatures) {
-            temp.multiply(params.hsig, t);
-            resampled.bsig.add(sk.bsig, temp);
+            resampled.bsig.copy(sk.bsig);
+            products.add(resampled.bsig, params.hsig);
         } else {
             resampled.bsig.copy(G1::zero);
         }
 
         if (supportFurtherQualification) {
             for (int i = 0; i != sk.l; i++) {
-                temp.multiply(params.h[sk.b[i].idx], t);
-                resampled.b[i].hexp.add(sk.b[i].hexp, temp);
+                resampled.b[i].hexp.copy(sk.b[i].hexp);
+                products.add(resampled.b[i].hexp, params.h[sk.b[i].idx]);
                 resampled.b[i].idx = sk.b[i].idx;
             }
             resampled.l = sk.l;
         } else {
             resampled.l = 0;
         }
+        products.flush();
     }
 
     void encrypt(Ciphertext& ciphertext, const GT& message, const Params& params, const AttributeList& attrs, void (*get_random_bytes)(void*, size_t)) {
@@ -369,22 +454,25 @@ namespace embedded_pairing::wkdibe {
     }
 
     void decrypt(GT& message, const Ciphertext& ciphertext, const SecretKey& sk) {
-        GT denominator;
-        G1Affine caffine;
-        G2Affine a1affine;
-        G1Affine a0affine;
-        G2Affine baffine;
-        caffine.from_projective(ciphertext.c);
-        a1affine.from_projective(sk.a1);
-        a0affine.from_projective(sk.a0);
-        baffine.from_projective(ciphertext.b);
+        G1Affine g1affine[2];
+        G2Affine g2affine[2];
+        {
+            G1 g1[2];
+            G2 g2[2];
+            g1[0].copy(ciphertext.c);
+            g1[1].copy(sk.a0);
+            g2[0].copy(sk.a1);
+            g2[1].copy(ciphertext.b);
+            G1Affine::batch_from_projective(g1affine, g1, 2);
+            G2Affine::batch_from_projective(g2affine, g2, 2);
+        }
 
-        a0affine.negate(a0affine);
+        g1affine[1].negate(g1affine[1]);
         bls12_381::AffinePair pairs[2];
-        pairs[0].g1 = &caffine;
-        pairs[0].g2 = &a1affine;
-        pairs[1].g1 = &a0affine;
-        pairs[1].g2 = &baffine;
+        pairs[0].g1 = &g1affine[0];
+        pairs[0].g2 = &g2affine[0];
+        pairs[1].g1 = &g1affine[1];
+        pairs[1].g2 = &g2affine[1];
         bls12_381::pairing_product(message, pairs, 2, nullptr, 0);
         message.multiply(message, ciphertext.a);
     }
@@ -422,20 +510,21 @@ namespace embedded_pairing::wkdibe {
         signature.a1.add(signature.a1, sk.a1);
 
         if (attrs != nullptr) {
+            MultiScalarSum a0(signature.a0);
             int k = 0;
             for (int i = 0; i != sk.l; i++) {
                 while (k != attrs->length && attrs->attrs[k].idx < sk.b[i].idx) {
                     k++;
                 }
                 if (k == attrs->length) {
-                    return;
+                    break;
                 }
                 if (sk.b[i].idx == attrs->attrs[k].idx) {
-                    prodexp.multiply(sk.b[i].hexp, attrs->attrs[k].id);
-                    signature.a0.add(signature.a0, prodexp);
+                    a0.add(sk.b[i].hexp, attrs->attrs[k].id);
                     k++;
                 }
             }
+            a0.flush();
         }
     }
 
@@ -446,29 +535,29 @@ namespace embedded_pairing::wkdibe {
     }
 
     bool verify_precomputed(const Params& params, const Precomputed& precomputed, const Signature& signature, const Scalar& message) {
-        G1Affine a0affine;
-        G2Affine gaffine;
-        G1Affine prodexpaffine;
-        G2Affine a1affine;
+        G1Affine g1affine[2];
+        G2Affine g2affine[2];
 
         {
-            G1 prodexp;
-            prodexp.multiply(params.hsig, message);
-            prodexp.add(prodexp, precomputed.prodexp);
-            a0affine.from_projective(signature.a0);
-            gaffine.from_projective(params.g);
-            prodexpaffine.from_projective(prodexp);
-            a1affine.from_projective(signature.a1);
+            G1 g1[2];
+            G2 g2[2];
+            g1[0].copy(signature.a0);
+            g1[1].multiply(params.hsig, message);
+            g1[1].add(g1[1], precomputed.prodexp);
+            g2[0].copy(params.g);
+            g2[1].copy(signature.a1);
+            G1Affine::batch_from_projective(g1affine, g1, 2);
+            G2Affine::batch_from_projective(g2affine, g2, 2);
         }
 
-        /* Compute e(a0affine, gaffine) / e(prodexpaffine, a1affine). */
+        /* Compute e(a0, g) / e(prodexp, a1). */
         GT ratio;
-        prodexpaffine.negate(prodexpaffine);
+        g1affine[1].negate(g1affine[1]);
         bls12_381::AffinePair pairs[2];
-        pairs[0].g1 = &a0affine;
-        pairs[0].g2 = &gaffine;
-        pairs[1].g1 = &prodexpaffine;
-        pairs[1].g2 = &a1affine;
+        pairs[0].g1 = &g1affine[0];
+        pairs[0].g2 = &g2affine[0];
+        pairs[1].g1 = &g1affine[1];
+        pairs[1].g2 = &g2affine[1];
         bls12_381::pairing_product(ratio, pairs, 2, nullptr, 0);
 
         return GT::equal(ratio, params.pairing);
@@ -46,64 +46,73 @@ namespace embedded_pairing::wkdibe {
         return ((temp & 0x00FF00FFu) << 8) | ((temp & 0xFF00FF00u) >> 8);
     }
 
-    template <bool compressed>
+    /*
+     * Maximum number of points converted to affine coordinates at once when
+     * marshalling. Larger batches need fewer inversions but more stack space.
+     */
+    static constexpr int marshal_batch_size = 16;
+
+    template <bool compressed, bool compressed_gt>
     struct ParamsMarshalled {
         uint8_t signature;
         Encoding<G2Affine, compressed> g;
         Encoding<G2Affine, compressed> g1;
         Encoding<G1Affine, compressed> g2;
         Encoding<G1Affine, compressed> g3;
-        uint8_t pairing[compressed ? 0 : sizeof(GT)];
+        uint8_t pairing[Params::marshalledPairingLength<compressed, compressed_gt>];
     };
 
-    template <bool compressed>
+    template <bool compressed, bool compressed_gt>
     void Params::marshal(void* buffer) const {
-        ParamsMarshalled<compressed>* encoded = static_cast<ParamsMarshalled<compressed>*>(buffer);
+        ParamsMarshalled<compressed, compressed_gt>* encoded = static_cast<ParamsMarshalled<compressed, compressed_gt>*>(buffer);
         encoded->signature = this->signatures ? 1 : 0;
 
-        G2Affine gaffine;
-        gaffine.from_projective(this->g);
-        encoded->g.encode(gaffine);
-
-        G2Affine g1affine;
-        g1affine.from_projective(this->g1);
-        encoded->g1.encode(g1affine);
-
-        G1Affine g2affine;
-        g2affine.from_projective(this->g2);
-        encoded->g2.encode(g2affine);
-
-        G1Affine g3affine;
-        g3affine.from_projective(this->g3);
-        encoded->g3.encode(g3affine);
+        /* Convert points to affine coordinates in batches, to share inversions. */
+        G2Affine gaffine[2];
+        G2 g[2];
+        g[0].copy(this->g);
+        g[1].copy(this->g1);
+        G2Affine::batch_from_projective(gaffine, g, 2);
+        encoded->g.encode(gaffine[0]);
+        encoded->g1.encode(gaffine[1]);
+
+        G1Affine g1affine[3];
+        G1 g1[3];
+        g1[0].copy(this->g2);
+        g1[1].copy(this->g3);
+        if (this->signatures) {
+            g1[2].copy(this->hsig);
+        }
+        G1Affine::batch_from_projective(g1affine, g1, this->signatures ? 3 : 2);
+        encoded->g2.encode(g1affine[0]);
+        encoded->g3.encode(g1affine[1]);
 
         if constexpr(!compressed) {
-            this->pairing.write_big_endian(encoded->pairing);
+            reinterpret_cast<Encoding<GT, compressed_gt>*>(encoded->pairing)->encode(this->pairing);
         }
 
         Encoding<G1Affine, compressed>* h;
         if (this->signatures) {
             Encoding<G1Affine, compressed>* hsig = reinterpret_cast<Encoding<G1Affine, compressed>*>(encoded + 1);
-
-            G1Affine hsigaffine;
-            hsigaffine.from_projective(this->hsig);
-            hsig->encode(hsigaffine);
-
+            hsig->encode(g1affine[2]);
             h = hsig + 1;
         } else {
             h = reinterpret_cast<Encoding<G1Affine, compressed>*>(encoded + 1);
         }
 
-        for (int i = 0; i != this->l; i++) {
-            G1Affine haffine;
-            haffine.from_projective(this->h[i]);
-            h[i].encode(haffine);
+        G1Affine haffine[marshal_batch_size];
+        for (int i = 0; i < this->l; i += marshal_batch_size) {
+            int batch = (this->l - i < marshal_batch_size) ? (this->l - i) : marshal_batch_size;
+            G1Affine::batch_from_projective(haffine, &this->h[i], batch);
+            for (int j = 0; j != batch; j++) {
+                h[i + j].encode(haffine[j]);
+            }
         }
     }
 
-    template <bool compressed>
+    template <bool compressed, bool compressed_gt>
     bool Params::unmarshal(const void* buffer, bool checked) {
-        const ParamsMarshalled<compressed>* encoded = static_cast<const ParamsMarshalled<compressed>*>(buffer);
+        const ParamsMarshalled<compressed, compressed_gt>* encoded = static_cast<const ParamsMarshalled<compressed, compressed_gt>*>(buffer);
         this->signatures = (encoded->signature != 0);
 
         G2Affine gaffine;
@@ -132,8 +141,8 @@ namespace embedded_pairing::wkdibe {
 
         if constexpr(compressed) {
             bls12_381::pairing(this->pairing, g2affine, g1affine);
-        } else {
-            this->pairing.read_big_endian(encoded->pairing);
+        } else if (!reinterpret_cast<const Encoding<GT, compressed_gt>*>(encoded->pairing)->decode(this->pairing, checked)) {
+            return false;
         }
 
         const Encoding<G1Affine, compressed>* h;
@@ -162,17 +171,17 @@ namespace embedded_pairing::wkdibe {
         return true;
     }
 
-    template <bool compressed>
+    template <bool compressed, bool compressed_gt>
     struct CiphertextMarshalled {
-        uint8_t a[sizeof(GT)];
+        Encoding<GT, compressed_gt> a;
         Encoding<G2Affine, compressed> b;
         Encoding<G1Affine, compressed> c;
     };
 
-    template <bool compressed>
+    template <bool compressed, bool compressed_gt>
     void Ciphertext::marshal(void* buffer) const {
-        CiphertextMarshalled<compressed>* encoded = static_cast<CiphertextMarshalled<compressed>*>(buffer);
-        this->a.write_big_endian(encoded->a);
+        CiphertextMarshalled<compressed, compressed_gt>* encoded = static_cast<CiphertextMarshalled<compressed, compressed_gt>*>(buffer);
+        encoded->a.encode(this->a);
 
         G2Affine baffine;
         baffine.from_projective(this->b);
@@ -183,10 +192,12 @@ namespace embedded_pairing::wkdibe {
         encoded->c.encode(caffine);
     }
 
-    template <bool compressed>
+    template <bool compressed, bool compressed_gt>
     bool Ciphertext::unmarshal(const void* buffer, bool checked) {
-        const CiphertextMarshalled<compressed>* encoded = reinterpret_cast<const CiphertextMarshalled<compressed>*>(buffer);
-        this->a.read_big_endian(encoded->a);
+        const CiphertextMarshalled<compressed, compressed_gt>* encoded = reinterpret_cast<const CiphertextMarshalled<compressed, compressed_gt>*>(buffer);
+        if (!encoded->a.decode(this->a, checked)) {
+            return false;
+        }
 
         G2Affine baffine;
         if (!encoded->b.decode(baffine, checked)) {
@@ -284,9 +295,14 @@ namespace embedded_pairing::wkdibe {
         SecretKeyMarshalled<compressed>* encoded = static_cast<SecretKeyMarshalled<compressed>*>(buffer);
         encoded->signature = this->signatures ? 1 : 0;
 
-        G1Affine a0affine;
-        a0affine.from_projective(this->a0);
-        encoded->a0.encode(a0affine);
+        G1Affine aaffine[2];
+        G1 a[2];
+        a[0].copy(this->a0);
+        if (this->signatures) {
+            a[1].copy(this->bsig);
+        }
+        G1Affine::batch_from_projective(aaffine, a, this->signatures ? 2 : 1);
+        encoded->a0.encode(aaffine[0]);
 
         G2Affine a1affine;
         a1affine.from_projective(this->a1);
@@ -295,18 +311,25 @@ namespace embedded_pairing::wkdibe {
         FreeSlotMarshalled<compressed>* b;
         if (this->signatures) {
             Encoding<G1Affine, compressed>* bsig = reinterpret_cast<Encoding<G1Affine, compressed>*>(encoded + 1);
-
-            G1Affine bsigaffine;
-            bsigaffine.from_projective(this->bsig);
-            bsig->encode(bsigaffine);
-
+            bsig->encode(aaffine[1]);
             b = reinterpret_cast<FreeSlotMarshalled<compressed>*>(bsig + 1);
         } else {
             b = reinterpret_cast<FreeSlotMarshalled<compressed>*>(encoded + 1);
         }
 
-        for (int i = 0; i != this->l; i++) {
-            this->b[i].marshal<compressed>(&b[i]);
+        /* Same as FreeSlot::marshal, but converting to affine in batches. */
+        G1 hexp[marshal_batch_size];
+        G1Affine hexpaffine[marshal_batch_size];
+        for (int i = 0; i < this->l; i += marshal_batch_size) {
+            int batch = (this->l - i < marshal_batch_size) ? (this->l - i) : marshal_batch_size;
+            for (int j = 0; j != batch; j++) {
+                hexp[j].copy(this->b[i + j].hexp);
+            }
+            G1Affine::batch_from_projective(hexpaffine, hexp, batch);
+            for (int j = 0; j != batch; j++) {
+                b[i + j].hexp.encode(hexpaffine[j]);
+                b[i + j].idx = uint32_swap_endianness(this->b[i + j].idx);
+            }
         }
     }
 
@@ -378,10 +401,18 @@ namespace embedded_pairing::wkdibe {
     template void Params::marshal<true>(void*) const;
     template bool Params::unmarshal<false>(const void*, bool);
     template bool Params::unmarshal<true>(const void*, bool);
+    template void Params::marshal<false, true>(void*) const;
+    template void Params::marshal<true, true>(void*) const;
+    template bool Params::unmarshal<false, true>(const void*, bool);
+    template bool Params::unmarshal<true, true>(const void*, bool);
     template void Ciphertext::marshal<false>(void*) const;
     template void Ciphertext::marshal<true>(void*) const;
     template bool Ciphertext::unmarshal<false>(const void*, bool);
     template bool Ciphertext::unmarshal<true>(const void*, bool);
+    template void Ciphertext::marshal<false, true>(void*) const;
+    template void Ciphertext::marshal<true, true>(void*) const;
+    template bool Ciphertext::unmarshal<false, true>(const void*, bool);
+    template bool Ciphertext::unmarshal<true, true>(const void*, bool);
     template void Signature::marshal<false>(void*) const;
     template void Signature::marshal<true>(void*) const;
     template bool Signature::unmarshal<false>(const void*, bool);
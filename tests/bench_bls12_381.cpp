@@ -7,6 +7,9 @@
 #include "bls12_381/fq12.hpp"
 #include "bls12_381/curve.hpp"
 #include "bls12_381/pairing.hpp"
+#include "bls12_381/fixed_base.hpp"
+#include "bls12_381/multi_scalar.hpp"
+#include "bls12_381/batch_multiply.hpp"
 
 using namespace embedded_pairing::bls12_381;
 using embedded_pairing::core::BigInt;
@@ -127,6 +130,166 @@ uint64_t bench_fq_square(void) {
     return end - start;
 }
 
+uint64_t bench_fq_batch_mul(void) {
+    Fq a[FqBatch::lanes];
+    Fq b[FqBatch::lanes];
+    for (int i = 0; i != FqBatch::lanes; i++) {
+        a[i].random(random_bytes);
+        b[i].random(random_bytes);
+    }
+
+    FqBatch x;
+    FqBatch y;
+    x.load(a);
+    y.load(b);
+
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        x.multiply(x, y);
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_fq_batch_square(void) {
+    Fq a[FqBatch::lanes];
+    for (int i = 0; i != FqBatch::lanes; i++) {
+        a[i].random(random_bytes);
+    }
+
+    FqBatch x;
+    x.load(a);
+
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        x.square(x);
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_fr_mul(void) {
+    Fr a;
+    Fr b;
+    a.random(random_bytes);
+    b.random(random_bytes);
+
+    Fr c;
+
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        c.multiply(a, b);
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_fr_square(void) {
+    Fr a;
+    a.random(random_bytes);
+
+    Fr c;
+
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        c.square(a);
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_fq_inverse(void) {
+    Fq a;
+    a.random(random_bytes);
+
+    Fq c;
+
+    uint64_t start = current_time_nanos();
+    c.inverse(a);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+Fq batch_inverse_in[100];
+Fq batch_inverse_out[100];
+
+uint64_t bench_fq_batch_inverse(void) {
+    for (int i = 0; i != 100; i++) {
+        batch_inverse_in[i].random(random_bytes);
+    }
+
+    uint64_t start = current_time_nanos();
+    embedded_pairing::core::batch_inverse(batch_inverse_out, batch_inverse_in, 100);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_fr_inverse(void) {
+    Fr a;
+    a.random(random_bytes);
+
+    Fr c;
+
+    uint64_t start = current_time_nanos();
+    embedded_pairing::core::fp_inverse(c, a);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+Fq array_a[64];
+Fq array_b[64];
+Fq array_c[64];
+
+template <size_t n, bool batched>
+uint64_t bench_fq_array_mul(void) {
+    for (size_t i = 0; i != n; i++) {
+        array_a[i].random(random_bytes);
+        array_b[i].random(random_bytes);
+    }
+
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        if (batched) {
+            embedded_pairing::core::batch_multiply(array_c, array_a, array_b, n);
+        } else {
+            for (size_t j = 0; j != n; j++) {
+                array_c[j].multiply(array_a[j], array_b[j]);
+            }
+        }
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+#if !defined(DISABLE_ASM) && (defined(__x86_64__) || defined(_M_X64_))
+/*
+ * Runtime dispatch never picks the AVX2 kernel on CPUs with BMI2/ADX, so this
+ * calls it directly, to find where it overtakes the scalar code.
+ */
+template <size_t n>
+uint64_t bench_fq_array_mul_avx2(void) {
+    for (size_t i = 0; i != n; i++) {
+        array_a[i].random(random_bytes);
+        array_b[i].random(random_bytes);
+    }
+
+    FqBatch x;
+    FqBatch y;
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        for (size_t j = 0; j < n; j += FqBatch::lanes) {
+            int count = (n - j < FqBatch::lanes) ? (int) (n - j) : FqBatch::lanes;
+            x.load(&array_a[j], count);
+            y.load(&array_b[j], count);
+            embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(&x, &x, &y, &Fq::p_value, Fq::inv_value.words[0]);
+            x.store(&array_c[j], count);
+        }
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+#endif
+
 uint64_t bench_g1_projective_add(void) {
     G1 a;
     G1 b;
@@ -183,6 +346,73 @@ uint64_t bench_g1_affine_scalar_mult(void) {
     return end - start;
 }
 
+template <typename Projective>
+uint64_t bench_g_fixed_base_scalar_mult(void) {
+    /* The table is too large to put on the stack. */
+    static FixedBaseTable<Projective> table;
+    static bool table_filled = false;
+    if (!table_filled) {
+        table.fill_table(Projective::one);
+        table_filled = true;
+    }
+
+    Projective a;
+    BigInt<256> x;
+    x.random(random_bytes);
+
+    uint64_t start = current_time_nanos();
+    table.multiply(a, x);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+template <typename Projective, typename Affine, size_t count>
+uint64_t bench_g_multi_scalar_mult(void) {
+    static Affine bases[count];
+    static bool bases_filled = false;
+    if (!bases_filled) {
+        for (size_t i = 0; i != count; i++) {
+            Projective g;
+            g.random_generator(random_bytes);
+            bases[i].from_projective(g);
+        }
+        bases_filled = true;
+    }
+
+    BigInt<256> scalars[count];
+    for (size_t i = 0; i != count; i++) {
+        scalars[i].random(random_bytes);
+    }
+
+    Projective a;
+
+    uint64_t start = current_time_nanos();
+    multi_scalar_multiply(a, bases, scalars, count);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+template <typename Projective, size_t count>
+uint64_t bench_g_batch_mult(void) {
+    static Projective bases[count];
+    static Projective results[count];
+    static bool bases_filled = false;
+    if (!bases_filled) {
+        for (size_t i = 0; i != count; i++) {
+            bases[i].random_generator(random_bytes);
+        }
+        bases_filled = true;
+    }
+
+    BigInt<256> x;
+    x.random(random_bytes);
+
+    uint64_t start = current_time_nanos();
+    batch_multiply(results, bases, count, x);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
 uint64_t bench_g1_convert_affine(void) {
     G1 a;
     a.random_generator(random_bytes);
@@ -195,6 +425,20 @@ uint64_t bench_g1_convert_affine(void) {
     return end - start;
 }
 
+G1 batch_convert_in[100];
+G1Affine batch_convert_out[100];
+
+uint64_t bench_g1_batch_convert_affine(void) {
+    for (int i = 0; i != 100; i++) {
+        batch_convert_in[i].random_generator(random_bytes);
+    }
+
+    uint64_t start = current_time_nanos();
+    G1Affine::batch_from_projective(batch_convert_out, batch_convert_in, 100);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
 template <bool compressed, bool checked>
 uint64_t bench_g1_unmarshal(void) {
     G1 a;
@@ -297,6 +541,36 @@ uint64_t bench_g2_unmarshal(void) {
     return end - start;
 }
 
+uint64_t bench_fq2_mult(void) {
+    Fq2 a;
+    Fq2 b;
+    a.random(random_bytes);
+    b.random(random_bytes);
+
+    Fq2 c;
+
+    uint64_t start = current_time_nanos();
+    for (int i = 0; i != 1000; i++) {
+        c.multiply(a, b);
+    }
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_fq6_mult(void) {
+    Fq6 a;
+    Fq6 b;
+    a.random(random_bytes);
+    b.random(random_bytes);
+
+    Fq6 c;
+
+    uint64_t start = current_time_nanos();
+    c.multiply(a, b);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
 uint64_t bench_fq12_mult(void) {
     Fq12 a;
     Fq12 b;
@@ -311,6 +585,24 @@ uint64_t bench_fq12_mult(void) {
     return end - start;
 }
 
+uint64_t bench_fq12_mult_by_c014(void) {
+    Fq12 a;
+    Fq2 c0;
+    Fq2 c1;
+    Fq2 c4;
+    a.random(random_bytes);
+    c0.random(random_bytes);
+    c1.random(random_bytes);
+    c4.random(random_bytes);
+
+    Fq12 c;
+
+    uint64_t start = current_time_nanos();
+    c.multiply_by_c014(a, c0, c1, c4);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
 uint64_t bench_fq12_exp(void) {
     Fq12 a;
     a.random(random_bytes);
@@ -403,6 +695,113 @@ uint64_t bench_pairing(void) {
     return end - start;
 }
 
+GTFixedBaseTable<> gt_fixed_base_table;
+bool gt_fixed_base_table_filled = false;
+
+uint64_t bench_fq12_random_gt_fixed_base(void) {
+    if (!gt_fixed_base_table_filled) {
+        gt_fixed_base_table.fill_table(generator_pairing);
+        gt_fixed_base_table_filled = true;
+    }
+
+    Fq12 c;
+    BigInt<256> x;
+
+    uint64_t start = current_time_nanos();
+    gt_fixed_base_table.random_gt(c, x, random_bytes);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_miller_loop(void) {
+    G1 a;
+    G2 b;
+    a.random_generator(random_bytes);
+    b.random_generator(random_bytes);
+
+    G1Affine a_aff;
+    G2Affine b_aff;
+    a_aff.from_projective(a);
+    b_aff.from_projective(b);
+
+    Fq12 res;
+
+    uint64_t start = current_time_nanos();
+    miller_loop(res, a_aff, b_aff);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_miller_loop_two_pairs(void) {
+    G1 a[2];
+    G2 b[2];
+    G1Affine a_aff[2];
+    G2Affine b_aff[2];
+    AffinePair pairs[2];
+    for (int i = 0; i != 2; i++) {
+        a[i].random_generator(random_bytes);
+        b[i].random_generator(random_bytes);
+        a_aff[i].from_projective(a[i]);
+        b_aff[i].from_projective(b[i]);
+        pairs[i].g1 = &a_aff[i];
+        pairs[i].g2 = &b_aff[i];
+    }
+
+    Fq12 res;
+
+    uint64_t start = current_time_nanos();
+    miller_loop(res, pairs, 2, nullptr, 0);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_final_exponentiation(void) {
+    G1 a;
+    G2 b;
+    a.random_generator(random_bytes);
+    b.random_generator(random_bytes);
+
+    G1Affine a_aff;
+    G2Affine b_aff;
+    a_aff.from_projective(a);
+    b_aff.from_projective(b);
+
+    Fq12 f;
+    miller_loop(f, a_aff, b_aff);
+
+    Fq12 res;
+
+    uint64_t start = current_time_nanos();
+    final_exponentiation(res, f);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
+uint64_t bench_final_exponentiation_batch(void) {
+    constexpr int n = 16;
+    Fq12 f[n];
+    for (int i = 0; i != n; i++) {
+        G1 a;
+        G2 b;
+        a.random_generator(random_bytes);
+        b.random_generator(random_bytes);
+
+        G1Affine a_aff;
+        G2Affine b_aff;
+        a_aff.from_projective(a);
+        b_aff.from_projective(b);
+
+        miller_loop(f[i], a_aff, b_aff);
+    }
+
+    Fq12 res[n];
+
+    uint64_t start = current_time_nanos();
+    final_exponentiation_batch(res, f, n);
+    uint64_t end = current_time_nanos();
+    return end - start;
+}
+
 extern "C" {
     void run_benchmarks(void);
 }
@@ -414,6 +813,32 @@ void run_benchmarks(void) {
     benchmark_time("1000 * Fq Montgomery", bench_fq_montgomery, default_duration);
     benchmark_time("1000 * Fq Multiply", bench_fq_mul, default_duration);
     benchmark_time("1000 * Fq Square", bench_fq_square, default_duration);
+    benchmark_time("1000 * Fr Multiply", bench_fr_mul, default_duration);
+    benchmark_time("1000 * Fr Square", bench_fr_square, default_duration);
+    benchmark_time("Fq Inverse", bench_fq_inverse, default_duration / 100);
+    benchmark_time("Fr Inverse", bench_fr_inverse, default_duration / 100);
+    benchmark_time("100 * Fq Batch Inverse", bench_fq_batch_inverse, default_duration / 10);
+    benchmark_time("1000 * Fq Batch Multiply (8 Lanes)", bench_fq_batch_mul, default_duration);
+    benchmark_time("1000 * Fq Batch Square (8 Lanes)", bench_fq_batch_square, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 1, Scalar)", bench_fq_array_mul<1, false>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 1, Batched)", bench_fq_array_mul<1, true>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 4, Scalar)", bench_fq_array_mul<4, false>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 4, Batched)", bench_fq_array_mul<4, true>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 8, Scalar)", bench_fq_array_mul<8, false>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 8, Batched)", bench_fq_array_mul<8, true>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 16, Scalar)", bench_fq_array_mul<16, false>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 16, Batched)", bench_fq_array_mul<16, true>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 64, Scalar)", bench_fq_array_mul<64, false>, default_duration);
+    benchmark_time("1000 * Fq Array Multiply (n = 64, Batched)", bench_fq_array_mul<64, true>, default_duration);
+#if !defined(DISABLE_ASM) && (defined(__x86_64__) || defined(_M_X64_))
+    if (embedded_pairing_core_arch_x86_64_cpu_supports_avx2()) {
+        benchmark_time("1000 * Fq Array Multiply (n = 1, AVX2)", bench_fq_array_mul_avx2<1>, default_duration);
+        benchmark_time("1000 * Fq Array Multiply (n = 4, AVX2)", bench_fq_array_mul_avx2<4>, default_duration);
+        benchmark_time("1000 * Fq Array Multiply (n = 8, AVX2)", bench_fq_array_mul_avx2<8>, default_duration);
+        benchmark_time("1000 * Fq Array Multiply (n = 16, AVX2)", bench_fq_array_mul_avx2<16>, default_duration);
+        benchmark_time("1000 * Fq Array Multiply (n = 64, AVX2)", bench_fq_array_mul_avx2<64>, default_duration);
+    }
+#endif
     printf("\n");
     benchmark_time("G1 Projective Add", bench_g1_projective_add, default_duration / 100);
     benchmark_time("G1 Projective Double-Add Mult", bench_g1_projective_scalar_mult<true, 0>, default_duration);
@@ -422,7 +847,11 @@ void run_benchmarks(void) {
     benchmark_time("G1 Affine w-NAF Mult", bench_g1_affine_scalar_mult<false, 4>, default_duration);
     benchmark_time("G1 Projective Mult", bench_g1_projective_scalar_mult<false, 0>, 2 * default_duration);
     benchmark_time("G1 Affine Mult", bench_g1_affine_scalar_mult<false, 0>, 2 * default_duration);
+    benchmark_time("G1 Fixed Base Mult", bench_g_fixed_base_scalar_mult<G1>, default_duration);
+    benchmark_time("64 * G1 Multi-Scalar Mult", bench_g_multi_scalar_mult<G1, G1Affine, 64>, default_duration);
+    benchmark_time("64 * G1 Batch Mult (Same Scalar)", bench_g_batch_mult<G1, 64>, default_duration);
     benchmark_time("G1 Convert to Affine", bench_g1_convert_affine, default_duration / 10);
+    benchmark_time("100 * G1 Batch Convert to Affine", bench_g1_batch_convert_affine, default_duration);
     benchmark_time("G1 Unmarshal: Compressed, Checked", bench_g1_unmarshal<true, true>, default_duration);
     benchmark_time("G1 Unmarshal: Uncompressed, Checked", bench_g1_unmarshal<false, true>, default_duration);
     benchmark_time("G1 Unmarshal: Compressed, Unchecked", bench_g1_unmarshal<true, false>, default_duration);
@@ -435,18 +864,29 @@ void run_benchmarks(void) {
     benchmark_time("G2 Affine w-NAF Mult", bench_g2_affine_scalar_mult<false, 4>, default_duration);
     benchmark_time("G2 Projective Mult", bench_g2_projective_scalar_mult<false, 0>, default_duration);
     benchmark_time("G2 Affine Mult", bench_g2_affine_scalar_mult<false, 0>, default_duration);
+    benchmark_time("G2 Fixed Base Mult", bench_g_fixed_base_scalar_mult<G2>, default_duration);
+    benchmark_time("64 * G2 Multi-Scalar Mult", bench_g_multi_scalar_mult<G2, G2Affine, 64>, default_duration);
+    benchmark_time("64 * G2 Batch Mult (Same Scalar)", bench_g_batch_mult<G2, 64>, default_duration);
     benchmark_time("G2 Convert to Affine", bench_g2_convert_affine, default_duration / 10);
     benchmark_time("G2 Unmarshal: Compressed, Checked", bench_g2_unmarshal<true, true>, default_duration);
     benchmark_time("G2 Unmarshal: Uncompressed, Checked", bench_g2_unmarshal<false, true>, default_duration);
     benchmark_time("G2 Unmarshal: Compressed, Unchecked", bench_g2_unmarshal<true, false>, default_duration);
     benchmark_time("G2 Unmarshal: Uncompressed, Unchecked", bench_g2_unmarshal<false, false>, default_duration / 1000);
     printf("\n");
+    benchmark_time("1000 * Fq2 Multiply", bench_fq2_mult, default_duration);
+    benchmark_time("Fq6 Multiply", bench_fq6_mult, default_duration);
     benchmark_time("Fq12 Multiply", bench_fq12_mult, default_duration);
+    benchmark_time("Fq12 Multiply C014 Terms", bench_fq12_mult_by_c014, default_duration);
     benchmark_time("Fq12 Exponentiate", bench_fq12_exp, default_duration);
     benchmark_time("Fq12 Exponentiate GT", bench_fq12_exp_gt, default_duration);
     benchmark_time("Fq12 Exponentiate GT (Platforms w/o Division)", bench_fq12_exp_gt_nodiv, default_duration);
     benchmark_time("Fq12 Exponentiate GT (Platforms w/ Division)", bench_fq12_exp_gt_div, default_duration);
     benchmark_time("Fq12 Random GT", bench_fq12_random_gt, default_duration);
+    benchmark_time("Fq12 Random GT (Fixed Base Table)", bench_fq12_random_gt_fixed_base, default_duration);
+    benchmark_time("Miller Loop (Affine)", bench_miller_loop, default_duration);
+    benchmark_time("Miller Loop (Affine, 2 Pairs)", bench_miller_loop_two_pairs, default_duration);
+    benchmark_time("Final Exponentiation", bench_final_exponentiation, default_duration);
+    benchmark_time("16 * Final Exponentiation (Batch)", bench_final_exponentiation_batch, default_duration);
     benchmark_time("Pairing (Affine)", bench_pairing, default_duration);
     printf("\nDONE\n");
 }
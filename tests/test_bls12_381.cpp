@@ -8,6 +8,9 @@
 #include "bls12_381/curve.hpp"
 #include "bls12_381/pairing.hpp"
 #include "bls12_381/wnaf.hpp"
+#include "bls12_381/fixed_base.hpp"
+#include "bls12_381/multi_scalar.hpp"
+#include "bls12_381/batch_multiply.hpp"
 
 using namespace embedded_pairing::bls12_381;
 using embedded_pairing::core::BigInt;
@@ -30,6 +33,53 @@ constexpr int many_iters = 1000000;
 /* Allows us to pass brace-enclosed initializer lists to macros. */
 #define ARR(...) __VA_ARGS__
 
+template <typename Field>
+const char* test_batch_inverse(void) {
+    constexpr int n = 17;
+    Field in[n];
+    Field out[n];
+    for (int i = 0; i != few_iters; i++) {
+        for (int j = 0; j != n; j++) {
+            in[j].random(random_bytes);
+        }
+        if (i % 2 == 1) {
+            in[0].copy(Field::zero);
+            in[i % n].copy(Field::zero);
+            in[n - 1].copy(Field::zero);
+        }
+
+        embedded_pairing::core::batch_inverse(out, in, n);
+
+        for (int j = 0; j != n; j++) {
+            Field expected;
+            if (in[j].is_zero()) {
+                expected.copy(Field::zero);
+            } else {
+                expected.inverse(in[j]);
+            }
+            if (!Field::equal(out[j], expected)) {
+                return "FAIL";
+            }
+        }
+    }
+
+    /* Single element, and a batch consisting only of zero. */
+    in[0].random(random_bytes);
+    embedded_pairing::core::batch_inverse(out, in, 1);
+    Field expected;
+    expected.inverse(in[0]);
+    if (!Field::equal(out[0], expected)) {
+        return "FAIL (single)";
+    }
+    in[0].copy(Field::zero);
+    embedded_pairing::core::batch_inverse(out, in, 1);
+    if (!out[0].is_zero()) {
+        return "FAIL (zero)";
+    }
+
+    return "PASS";
+}
+
 const char* test_fr_legendre(void) {
     if (Fr::one.legendre() != 1) {
         return "FAIL (one)";
@@ -426,6 +476,7 @@ void test_bls12_381_fr(void) {
     printf("Multiplication...\t%s\n", test_fr_mul());
     printf("Squaring...\t\t%s\n", test_fr_squaring());
     printf("Inverse...\t\t%s\n", test_fr_inverse());
+    printf("Batch Inverse...\t%s\n", test_batch_inverse<Fr>());
     printf("Double...\t\t%s\n", test_fr_double());
     printf("Negate...\t\t%s\n", test_fr_negate());
     printf("Exponentiate...\t\t%s\n", test_fr_pow());
@@ -835,6 +886,183 @@ const char* test_fq_sqrt(void) {
     return "PASS";
 }
 
+template <typename Field>
+const char* test_checked_sqrt(void) {
+    Field res;
+    if (!res.checked_square_root(Field::zero) || !res.is_zero()) {
+        return "FAIL (zero)";
+    }
+
+    /* Compare against the Legendre symbol, for squares and nonsquares. */
+    for (int i = 0; i != std_iters; i++) {
+        Field a;
+        a.random(random_bytes);
+
+        bool exists = res.checked_square_root(a);
+        if (exists != (a.legendre() == 1)) {
+            return "FAIL (existence)";
+        }
+
+        if (exists) {
+            Field tmp;
+            tmp.square(res);
+            if (!Field::equal(tmp, a)) {
+                return "FAIL (square of sqrt)";
+            }
+        }
+    }
+
+    return "PASS";
+}
+
+const char* test_fq_batch(void) {
+    /* Ensure that the batch routines agree with the scalar ones. */
+    for (int i = 0; i != std_iters; i++) {
+        Fq a[FqBatch::lanes];
+        Fq b[FqBatch::lanes];
+        for (int j = 0; j != FqBatch::lanes; j++) {
+            a[j].random(random_bytes);
+            b[j].random(random_bytes);
+        }
+        if (i == 0) {
+            /* Largest possible inputs. */
+            a[0].copy(Fq::negative_one);
+            b[0].copy(Fq::negative_one);
+        }
+
+        FqBatch x;
+        FqBatch y;
+        x.load(a);
+        y.load(b);
+        x.multiply(x, y);
+        y.square(y);
+
+        Fq product[FqBatch::lanes];
+        Fq square[FqBatch::lanes];
+        x.store(product);
+        y.store(square);
+
+        for (int j = 0; j != FqBatch::lanes; j++) {
+            Fq expected;
+            expected.multiply(a[j], b[j]);
+            if (!Fq::equal(product[j], expected)) {
+                return "FAIL (multiply)";
+            }
+            expected.square(b[j]);
+            if (!Fq::equal(square[j], expected)) {
+                return "FAIL (square)";
+            }
+        }
+    }
+
+    /* Ensure that arrays whose length is not a multiple of lanes work. */
+    {
+        constexpr size_t n = 2 * FqBatch::lanes + 3;
+        Fq a[n];
+        Fq b[n];
+        Fq c[n];
+        for (size_t j = 0; j != n; j++) {
+            a[j].random(random_bytes);
+            b[j].random(random_bytes);
+        }
+        embedded_pairing::core::batch_multiply(c, a, b, n);
+        for (size_t j = 0; j != n; j++) {
+            Fq expected;
+            expected.multiply(a[j], b[j]);
+            if (!Fq::equal(c[j], expected)) {
+                return "FAIL (array)";
+            }
+        }
+    }
+
+    return "PASS";
+}
+
+#if !defined(DISABLE_ASM) && (defined(__x86_64__) || defined(_M_X64_))
+const char* test_fq_batch_avx2(void) {
+    /*
+     * Runtime dispatch only picks the AVX2 kernel on CPUs without BMI2/ADX,
+     * so call it directly and compare it with the scalar routines.
+     */
+    if (!embedded_pairing_core_arch_x86_64_cpu_supports_avx2()) {
+        return "PASS (AVX2 not supported)";
+    }
+
+    for (int i = 0; i != std_iters; i++) {
+        Fq a[FqBatch::lanes];
+        Fq b[FqBatch::lanes];
+        for (int j = 0; j != FqBatch::lanes; j++) {
+            a[j].random(random_bytes);
+            b[j].random(random_bytes);
+        }
+        if (i == 0) {
+            /* Largest possible inputs, in every lane. */
+            for (int j = 0; j != FqBatch::lanes; j++) {
+                a[j].copy(Fq::negative_one);
+                b[j].copy(Fq::negative_one);
+            }
+        } else if (i == 1) {
+            /* Largest possible inputs mixed with zero and one. */
+            for (int j = 0; j != FqBatch::lanes; j++) {
+                a[j].copy((j & 0x1) == 0 ? Fq::negative_one : Fq::zero);
+                b[j].copy((j & 0x2) == 0 ? Fq::negative_one : Fq::one);
+            }
+        }
+
+        FqBatch x;
+        FqBatch y;
+        FqBatch z;
+        x.load(a);
+        y.load(b);
+
+        /* Separate output. */
+        embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(&z, &x, &y, &Fq::p_value, Fq::inv_value.words[0]);
+        Fq product[FqBatch::lanes];
+        z.store(product);
+        embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_square(&z, &y, &Fq::p_value, Fq::inv_value.words[0]);
+        Fq square[FqBatch::lanes];
+        z.store(square);
+
+        /* Aliased output. */
+        embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_square(&x, &x, &Fq::p_value, Fq::inv_value.words[0]);
+        Fq square_aliased[FqBatch::lanes];
+        x.store(square_aliased);
+        x.load(a);
+        embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(&x, &x, &y, &Fq::p_value, Fq::inv_value.words[0]);
+        embedded_pairing_core_arch_x86_64_avx2_fpbatch_384_multiply(&y, &x, &y, &Fq::p_value, Fq::inv_value.words[0]);
+        Fq product_aliased[FqBatch::lanes];
+        Fq product_twice[FqBatch::lanes];
+        x.store(product_aliased);
+        y.store(product_twice);
+
+        for (int j = 0; j != FqBatch::lanes; j++) {
+            Fq expected;
+            expected.multiply(a[j], b[j]);
+            if (!Fq::equal(product[j], expected)) {
+                return "FAIL (multiply)";
+            }
+            if (!Fq::equal(product_aliased[j], expected)) {
+                return "FAIL (multiply, aliased)";
+            }
+            expected.multiply(expected, b[j]);
+            if (!Fq::equal(product_twice[j], expected)) {
+                return "FAIL (multiply, aliased second operand)";
+            }
+            expected.square(b[j]);
+            if (!Fq::equal(square[j], expected)) {
+                return "FAIL (square)";
+            }
+            expected.square(a[j]);
+            if (!Fq::equal(square_aliased[j], expected)) {
+                return "FAIL (square, aliased)";
+            }
+        }
+    }
+
+    return "PASS";
+}
+#endif
+
 void test_bls12_381_fq(void) {
     printf("Fq:\n");
     printf("Legendre...\t\t%s\n", test_fq_legendre());
@@ -843,10 +1071,16 @@ void test_bls12_381_fq(void) {
     printf("Multiplication...\t%s\n", test_fq_mul());
     printf("Squaring...\t\t%s\n", test_fq_squaring());
     printf("Inverse...\t\t%s\n", test_fq_inverse());
+    printf("Batch Inverse...\t%s\n", test_batch_inverse<Fq>());
     printf("Double...\t\t%s\n", test_fq_double());
     printf("Negate...\t\t%s\n", test_fq_negate());
     printf("Exponentiate...\t\t%s\n", test_fq_pow());
     printf("Square Root...\t\t%s\n", test_fq_sqrt());
+    printf("Checked Square Root...\t%s\n", test_checked_sqrt<Fq>());
+    printf("Batch...\t\t%s\n", test_fq_batch());
+#if !defined(DISABLE_ASM) && (defined(__x86_64__) || defined(_M_X64_))
+    printf("Batch (AVX2)...\t\t%s\n", test_fq_batch_avx2());
+#endif
     printf("\n");
 }
 
@@ -1087,7 +1321,9 @@ const char* test_frobenius_random(void) {
         BigInt<384> sum_c1_bi = res_c1; \
         expected.c0.set(sum_c0_bi); \
         expected.c1.set(sum_c1_bi); \
-        if (!Fq2::equal(c, expected)) { \
+        Fq2 negexpected; \
+        negexpected.negate(expected); \
+        if (!Fq2::equal(c, expected) && !Fq2::equal(c, negexpected)) { \
             return "FAIL (" name ")"; \
         } \
     } while (0)
@@ -1104,6 +1340,23 @@ const char* test_fq2_sqrt(void) {
                   BigInt<384>::zero,
                   ARR({.std_words = {0xfd4357a3, 0xb9feffff, 0xb153ffff, 0x1eabfffe, 0xf6b0f624, 0x6730d2a0, 0xf38512bf, 0x64774b84, 0x434bacd7, 0x4b1ba7b6, 0x397fe69a, 0x1a0111ea}}));
 
+    /* Ensure that sqrt(a)^2 == a for a in Fq, whether or not a is a square in Fq. */
+    for (int i = 0; i != std_iters; i++) {
+        Fq2 a;
+        a.c0.random(random_bytes);
+        a.c1.copy(Fq::zero);
+
+        Fq2 tmp1;
+        Fq2 tmp2;
+
+        tmp2.square_root(a);
+        tmp1.square(tmp2);
+
+        if (!Fq2::equal(tmp1, a)) {
+            return "FAIL (square of sqrt in Fq)";
+        }
+    }
+
     return "PASS";
 }
 
@@ -1185,9 +1438,11 @@ void test_bls12_381_fq2(void) {
     printf("Frobenius...\t\t%s\n", test_fq2_frobenius());
     printf("Frobenius (random)...\t%s\n", test_frobenius_random<Fq2, Fq::p_value, 13>());
     printf("Square Root...\t\t%s\n", test_fq2_sqrt());
+    printf("Checked Square Root...\t%s\n", test_checked_sqrt<Fq2>());
     printf("Legendre...\t\t%s\n", test_fq2_legendre());
     printf("Multiply Nonresidue...\t%s\n", test_fq2_mul_nonresidue());
     printf("Exponentiate...\t\t%s\n", test_fq2_pow());
+    printf("Batch Inverse...\t%s\n", test_batch_inverse<Fq2>());
     printf("\n");
 }
 
@@ -1345,6 +1600,29 @@ void test_bls12_381_fq6(void) {
     printf("\n");
 }
 
+const char* test_fq12_mul_c014_by_c014(void) {
+    for (int i = 0; i != std_iters; i++) {
+        Fq2 a[3];
+        Fq2 b[3];
+        for (int j = 0; j != 3; j++) {
+            a[j].random(random_bytes);
+            b[j].random(random_bytes);
+        }
+
+        Fq12 tmp1;
+        Fq12 tmp2;
+        tmp1.multiply_c014_by_c014(a[0], a[1], a[2], b[0], b[1], b[2]);
+        tmp2.multiply_by_c014(Fq12::one, a[0], a[1], a[2]);
+        tmp2.multiply_by_c014(tmp2, b[0], b[1], b[2]);
+
+        if (!Fq12::equal(tmp1, tmp2)) {
+            return "FAIL";
+        }
+    }
+
+    return "PASS";
+}
+
 const char* test_fq12_mul_by_c014(void) {
     Fq12 term = Fq12::zero;
 
@@ -1502,6 +1780,48 @@ const char* test_fq12_pow_cyclotomic_nodiv(void) {
     return "PASS";
 }
 
+const char* test_fq12_squaring_compressed(void) {
+    /* More than one chunk of batch_decompress. */
+    constexpr int n = 19;
+    Fq12 expected[n];
+    Fq12Compressed compressed[n];
+    Fq12 decompressed[n];
+
+    for (int i = 0; i != few_iters; i++) {
+        /* Squaring repeatedly (including zero times) must match square_cyclotomic. */
+        for (int j = 0; j != n; j++) {
+            BigInt<256> power;
+            expected[j].random_gt(power, generator_pairing, random_bytes);
+            compressed[j].compress(expected[j]);
+            for (int k = 0; k != 7 * j; k++) {
+                expected[j].square_cyclotomic(expected[j]);
+                compressed[j].square(compressed[j]);
+            }
+        }
+
+        Fq12Compressed::batch_decompress(decompressed, compressed, n);
+        for (int j = 0; j != n; j++) {
+            if (!Fq12::equal(decompressed[j], expected[j])) {
+                return "FAIL (batch)";
+            }
+            compressed[j].decompress(decompressed[j]);
+            if (!Fq12::equal(decompressed[j], expected[j])) {
+                return "FAIL (single)";
+            }
+        }
+    }
+
+    /* The identity has a zero denominator in the decompression formula. */
+    compressed[0].compress(Fq12::one);
+    compressed[0].square(compressed[0]);
+    compressed[0].decompress(decompressed[0]);
+    if (!Fq12::equal(decompressed[0], Fq12::one)) {
+        return "FAIL (one)";
+    }
+
+    return "PASS";
+}
+
 const char* test_fq12_gt_random(void) {
     for (int i = 0; i != std_iters; i++) {
         Fq12 a;
@@ -1519,16 +1839,51 @@ const char* test_fq12_gt_random(void) {
     return "PASS";
 }
 
+template <unsigned int teeth, unsigned int blocks>
+const char* test_fq12_gt_fixed_base(void) {
+    /* The default table is too large to put on the stack. */
+    static GTFixedBaseTable<teeth, blocks> table;
+    Fq12 base;
+    BigInt<256> power;
+    base.random_gt(power, generator_pairing, random_bytes);
+    table.fill_table(base);
+
+    for (int i = 0; i != std_iters; i++) {
+        Fq12 tmp1;
+        Fq12 tmp2;
+
+        table.random_gt(tmp2, power, random_bytes);
+        tmp1.exponentiate_gt(base, power);
+        if (!Fq12::equal(tmp1, tmp2)) {
+            return "FAIL";
+        }
+    }
+
+    Fq12 result;
+    power.clear();
+    table.exponentiate(result, power);
+    if (!Fq12::equal(result, Fq12::one)) {
+        return "FAIL (zero)";
+    }
+
+    return "PASS";
+}
+
 void test_bls12_381_fq12(void) {
     printf("Fq12:\n");
     printf("Multiply C014 Terms...\t%s\n", test_fq12_mul_by_c014());
+    printf("Multiply C014 by C014...\t%s\n", test_fq12_mul_c014_by_c014());
     printf("Inverse...\t\t%s\n", test_fq12_inverse());
+    printf("Batch Inverse...\t%s\n", test_batch_inverse<Fq12>());
     printf("Squaring...\t\t%s\n", test_fq12_squaring());
     printf("Exponentiation...\t%s\n", test_fq12_pow());
     printf("Cyclotomic Squaring...\t%s\n", test_fq12_squaring_cyclotomic());
+    printf("Compressed Squaring...\t%s\n", test_fq12_squaring_compressed());
     printf("Cyclotomic Exp...\t%s\n", test_fq12_pow_cyclotomic());
     printf("Cyclotomic Exp (Platforms w/o Division)...\t%s\n", test_fq12_pow_cyclotomic_nodiv());
     printf("GT Random...\t\t%s\n", test_fq12_gt_random());
+    printf("GT Fixed Base...\t%s\n", test_fq12_gt_fixed_base<4, 64>());
+    printf("GT Fixed Base (Small)...\t%s\n", test_fq12_gt_fixed_base<2, 8>());
     printf("Frobenius (random)...\t%s\n", test_frobenius_random<Fq12, Fq::p_value, 13>());
     printf("\n");
 }
@@ -1785,6 +2140,175 @@ const char* test_g_encoding(void) {
     return "PASS";
 }
 
+template <typename Projective, unsigned int teeth, unsigned int blocks>
+const char* test_g_fixed_base(void) {
+    /* The default table is too large to put on the stack. */
+    static FixedBaseTable<Projective, teeth, blocks> table;
+    Projective base;
+    base.random_generator(random_bytes);
+    table.fill_table(base);
+
+    BigInt<256> scalar;
+    Projective tmp1;
+    Projective tmp2;
+    for (int i = 0; i != std_iters; i++) {
+        Fr s;
+        s.random(random_bytes);
+        s.get(scalar);
+
+        table.multiply(tmp1, scalar);
+        tmp2.multiply_doubleadd(base, scalar);
+        if (!Projective::equal(tmp1, tmp2)) {
+            return "FAIL";
+        }
+    }
+
+    /* All 256 bits, including ones beyond the group order. */
+    memset(scalar.bytes, 0xFF, sizeof(scalar.bytes));
+    table.multiply(tmp1, scalar);
+    tmp2.multiply_doubleadd(base, scalar);
+    if (!Projective::equal(tmp1, tmp2)) {
+        return "FAIL (all ones)";
+    }
+
+    scalar.clear();
+    table.multiply(tmp1, scalar);
+    if (!tmp1.is_zero()) {
+        return "FAIL (zero)";
+    }
+
+    return "PASS";
+}
+
+template <typename Projective, typename Base>
+const char* test_g_multi_scalar(void) {
+    /*
+     * Separate multiplication (n <= 2), Straus in one chunk (n = 3, 7) and in
+     * several chunks (n = 17, 18), and Pippenger with a few window sizes.
+     */
+    constexpr int max_n = 150;
+    static Base bases[max_n];
+    static BigInt<256> scalars[max_n];
+    for (int i = 0; i != max_n; i++) {
+        Projective p;
+        p.random_generator(random_bytes);
+        bases[i].set(p);
+        Fr s;
+        s.random(random_bytes);
+        s.get(scalars[i]);
+    }
+
+    /* Repeated bases, and scalars that are zero or have every bit set. */
+    bases[3].set(bases[2]);
+    bases[5].set(bases[2]);
+    scalars[4].clear();
+    memset(scalars[6].bytes, 0xFF, sizeof(scalars[6].bytes));
+
+    const int sizes[] = {0, 1, 2, 3, 7, 17, 18, 20, 40, max_n};
+    for (int n : sizes) {
+        Projective expected;
+        expected.copy(Projective::zero);
+        for (int i = 0; i != n; i++) {
+            Projective term;
+            term.multiply_doubleadd(bases[i], scalars[i]);
+            expected.add(expected, term);
+        }
+
+        Projective result;
+        multi_scalar_multiply(result, bases, scalars, n);
+        if (!Projective::equal(result, expected)) {
+            return "FAIL";
+        }
+    }
+
+    return "PASS";
+}
+
+template <typename Projective, typename Base>
+const char* test_g_batch_multiply(void) {
+    /* Enough bases for several chunks, and a few that are zero or repeated. */
+    constexpr int max_n = 70;
+    static Base bases[max_n];
+    static Base results[max_n];
+    for (int i = 0; i != max_n; i++) {
+        Projective p;
+        p.random_generator(random_bytes);
+        bases[i].set(p);
+    }
+    bases[1].set(Projective::zero);
+    bases[3].set(bases[2]);
+
+    /* A random scalar, zero, one, and a scalar with every bit set. */
+    BigInt<256> scalars[4];
+    Fr s;
+    s.random(random_bytes);
+    s.get(scalars[0]);
+    scalars[1].clear();
+    scalars[2].clear();
+    scalars[2].bytes[0] = 1;
+    memset(scalars[3].bytes, 0xFF, sizeof(scalars[3].bytes));
+
+    const int sizes[] = {0, 1, 4, 5, 33, max_n};
+    for (const BigInt<256>& scalar : scalars) {
+        for (int n : sizes) {
+            batch_multiply(results, bases, n, scalar);
+            for (int i = 0; i != n; i++) {
+                Projective expected;
+                Projective result;
+                expected.multiply_doubleadd(bases[i], scalar);
+                result.set(results[i]);
+                if (!Projective::equal(result, expected)) {
+                    return "FAIL";
+                }
+            }
+        }
+    }
+
+    /* The results may overwrite the bases. */
+    Projective expected;
+    expected.multiply_doubleadd(bases[max_n - 1], scalars[0]);
+    batch_multiply(bases, bases, max_n, scalars[0]);
+    Projective result;
+    result.set(bases[max_n - 1]);
+    if (!Projective::equal(result, expected)) {
+        return "FAIL (in place)";
+    }
+
+    return "PASS";
+}
+
+template <typename Projective, typename Affine>
+const char* test_g_batch_affine(void) {
+    /* Cover more than one chunk, with a partial one at the end. */
+    constexpr int n = (int) Affine::batch_chunk_size + 13;
+    Projective in[n];
+    Affine out[n];
+    for (int i = 0; i != few_iters; i++) {
+        for (int j = 0; j != n; j++) {
+            /* Make sure that z is not one. */
+            in[j].random_generator(random_bytes);
+            in[j].multiply2(in[j]);
+        }
+        if (i % 2 == 1) {
+            in[0].copy(Projective::zero);
+            in[i % n].copy(Projective::zero);
+            in[n - 1].copy(Projective::zero);
+        }
+
+        Affine::batch_from_projective(out, in, n);
+
+        for (int j = 0; j != n; j++) {
+            Affine expected;
+            expected.from_projective(in[j]);
+            if (!Affine::equal(out[j], expected)) {
+                return "FAIL";
+            }
+        }
+    }
+
+    return "PASS";
+}
+
 template<typename Result, typename Base, unsigned int window>
 const char* test_g_wnaf(void) {
     /*
@@ -1818,6 +2342,100 @@ const char* test_g_wnaf(void) {
     return "PASS";
 }
 
+template<typename Projective, unsigned int window>
+const char* test_g_wnaf_table(void) {
+    /*
+     * Compare multiplication using a normalized w-NAF table with
+     * multiplication using a table of projective points.
+     */
+    typedef typename Projective::BaseFieldType BaseField;
+    Projective a;
+    BigInt<Fr::bits_value> scalar;
+    WnafTable<Projective, window, true> normalized;
+    WnafTable<Projective, window, false> projective;
+    WnafScalar<Fr::bits_value, window> wnaf;
+
+    Projective tmp1;
+    Projective tmp2;
+
+    for (int i = 0; i != std_iters; i++) {
+        if (i == 0) {
+            a.copy(Projective::zero);
+        } else {
+            a.random_generator(random_bytes);
+            a.multiply2(a);
+        }
+        scalar.random(random_bytes);
+
+        normalized.fill_table(a);
+        projective.fill_table(a);
+        for (int j = 0; j != normalized.table_size; j++) {
+            if (!Projective::equal(normalized.table[j], projective.table[j])) {
+                return "FAIL (table entries differ)";
+            }
+            if (i != 0 && !BaseField::equal(normalized.table[j].z, BaseField::one)) {
+                return "FAIL (table not normalized)";
+            }
+        }
+
+        wnaf.from_bigint(scalar);
+        wnaf_table_multiply(tmp1, normalized, wnaf);
+        wnaf_table_multiply(tmp2, projective, wnaf);
+
+        if (!Projective::equal(tmp1, tmp2)) {
+            return "FAIL (normalized != projective)";
+        }
+    }
+
+    return "PASS";
+}
+
+template<typename Projective, unsigned int window>
+const char* test_g_wnaf_recode(void) {
+    /*
+     * Compare multiplication using WnafScalar and using WnafRecoder with
+     * double-add multiplication, for the given (possibly wide) window.
+     */
+    Projective a;
+    BigInt<Fr::bits_value> scalar;
+    WnafTable<Projective, window> table;
+    WnafScalar<Fr::bits_value, window> wnaf;
+    WnafRecoder<Fr::bits_value, window> recoder;
+
+    Projective tmp1;
+    Projective tmp2;
+    Projective tmp3;
+
+    a.random_generator(random_bytes);
+    table.fill_table(a);
+
+    for (int i = 0; i != std_iters; i++) {
+        scalar.random(random_bytes);
+        if (i == 0) {
+            scalar.clear();
+        } else if (i == 1) {
+            memset(scalar.bytes, 0xFF, sizeof(scalar.bytes));
+        }
+
+        tmp1.multiply_doubleadd(a, scalar);
+
+        wnaf.from_bigint(scalar);
+        wnaf_table_multiply(tmp2, table, wnaf);
+
+        recoder.from_bigint(scalar);
+        wnaf_table_multiply(tmp3, table, recoder);
+
+        if (!Projective::equal(tmp1, tmp2)) {
+            return "FAIL (double-add != wnaf)";
+        }
+        if (!Projective::equal(tmp1, tmp3)) {
+            return "FAIL (double-add != recoder)";
+        }
+    }
+
+    return "PASS";
+}
+
 void test_bls12_381_g1(void) {
     printf("G1:\n");
     printf("Generator...\t\t%s\n", test_g1_generator());
@@ -1829,7 +2447,17 @@ void test_bls12_381_g1(void) {
     printf("Multiplication (A)...\t%s\n", test_g_mul<G1, G1Affine>());
     printf("w-NAF Mult (P)...\t%s\n", test_g_wnaf<G1, G1, 4>());
     printf("w-NAF Mult (A)...\t%s\n", test_g_wnaf<G1, G1Affine, 4>());
+    printf("w-NAF Table...\t\t%s\n", test_g_wnaf_table<G1, 4>());
+    printf("w-NAF Recode (4)...\t%s\n", test_g_wnaf_recode<G1, 4>());
+    printf("w-NAF Recode (9)...\t%s\n", test_g_wnaf_recode<G1, 9>());
     printf("Encoding...\t\t%s\n", test_g_encoding<G1, G1Affine, G1Uncompressed, G1Compressed>());
+    printf("Batch Affine...\t\t%s\n", test_g_batch_affine<G1, G1Affine>());
+    printf("Fixed Base...\t\t%s\n", test_g_fixed_base<G1, 8, 4>());
+    printf("Fixed Base (Small)...\t%s\n", test_g_fixed_base<G1, 2, 8>());
+    printf("Multi-Scalar (P)...\t%s\n", test_g_multi_scalar<G1, G1>());
+    printf("Multi-Scalar (A)...\t%s\n", test_g_multi_scalar<G1, G1Affine>());
+    printf("Batch Multiply (P)...\t%s\n", test_g_batch_multiply<G1, G1>());
+    printf("Batch Multiply (A)...\t%s\n", test_g_batch_multiply<G1, G1Affine>());
     printf("\n");
 }
 
@@ -1989,7 +2617,16 @@ void test_bls12_381_g2(void) {
     printf("Multiplication (A)...\t%s\n", test_g_mul<G2, G2Affine>());
     printf("w-NAF Mult (P)...\t%s\n", test_g_wnaf<G2, G2, 4>());
     printf("w-NAF Mult (A)...\t%s\n", test_g_wnaf<G2, G2Affine, 4>());
+    printf("w-NAF Table...\t\t%s\n", test_g_wnaf_table<G2, 3>());
+    printf("w-NAF Recode (8)...\t%s\n", test_g_wnaf_recode<G2, 8>());
     printf("Encoding...\t\t%s\n", test_g_encoding<G2, G2Affine, G2Uncompressed, G2Compressed>());
+    printf("Batch Affine...\t\t%s\n", test_g_batch_affine<G2, G2Affine>());
+    printf("Fixed Base...\t\t%s\n", test_g_fixed_base<G2, 8, 4>());
+    printf("Fixed Base (Small)...\t%s\n", test_g_fixed_base<G2, 2, 8>());
+    printf("Multi-Scalar (P)...\t%s\n", test_g_multi_scalar<G2, G2>());
+    printf("Multi-Scalar (A)...\t%s\n", test_g_multi_scalar<G2, G2Affine>());
+    printf("Batch Multiply (P)...\t%s\n", test_g_batch_multiply<G2, G2>());
+    printf("Batch Multiply (A)...\t%s\n", test_g_batch_multiply<G2, G2Affine>());
     printf("\n");
 }
 
@@ -2230,12 +2867,339 @@ const char* test_pairing_miller(void) {
     return "PASS";
 }
 
+const char* test_pairing_batch(void) {
+    /* More than one chunk, with the last one partial. */
+    constexpr int n = 21;
+    G1Affine a[n];
+    G2Affine b[n];
+    Fq12 f[n];
+    Fq12 results[n];
+
+    for (int i = 0; i != n; i++) {
+        G1 aproj;
+        G2 bproj;
+        aproj.random_generator(random_bytes);
+        bproj.random_generator(random_bytes);
+        a[i].from_projective(aproj);
+        b[i].from_projective(bproj);
+        miller_loop(f[i], a[i], b[i]);
+    }
+
+    final_exponentiation_batch(results, f, n);
+    for (int i = 0; i != n; i++) {
+        Fq12 expected;
+        final_exponentiation(expected, f[i]);
+        if (!Fq12::equal(results[i], expected)) {
+            return "FAIL (final exponentiation)";
+        }
+    }
+
+    pairing_batch(results, a, b, n);
+    for (int i = 0; i != n; i++) {
+        Fq12 expected;
+        pairing(expected, a[i], b[i]);
+        if (!Fq12::equal(results[i], expected)) {
+            return "FAIL (pairing)";
+        }
+    }
+
+    /* In place, for a single element. */
+    results[0].copy(f[0]);
+    final_exponentiation_batch(results, results, 1);
+    Fq12 expected;
+    final_exponentiation(expected, f[0]);
+    if (!Fq12::equal(results[0], expected)) {
+        return "FAIL (single)";
+    }
+
+    return "PASS";
+}
+
+/* Runs the tasks one at a time, in reverse order. */
+void test_serial_parallel_for(void* executor, void (*task)(void*, size_t), void* arg, size_t count) {
+    size_t* max_count = static_cast<size_t*>(executor);
+    if (count > *max_count) {
+        *max_count = count;
+    }
+    for (size_t i = count; i != 0; i--) {
+        task(arg, i - 1);
+    }
+}
+
+const char* test_pairing_parallel(void) {
+    constexpr int n = 5;
+    G1Affine a[n];
+    G2Affine b[n];
+    AffinePair affine_pairs[n];
+    for (int i = 0; i != n; i++) {
+        G1 aproj;
+        G2 bproj;
+        aproj.random_generator(random_bytes);
+        bproj.random_generator(random_bytes);
+        a[i].from_projective(aproj);
+        b[i].from_projective(bproj);
+        affine_pairs[i].g1 = &a[i];
+        affine_pairs[i].g2 = &b[i];
+    }
+    b[1].copy(G2Affine::zero);
+
+#if defined(__ARM_ARCH_6M__) // Not enough memory on this platform
+    constexpr int m = 0;
+    PreparedPair* prepared_pairs = nullptr;
+#else
+    constexpr int m = 2;
+    G1Affine c[m];
+    G2Prepared d[m];
+    PreparedPair prepared_pairs[m];
+    for (int i = 0; i != m; i++) {
+        G1 cproj;
+        G2 dproj;
+        cproj.random_generator(random_bytes);
+        dproj.random_generator(random_bytes);
+        c[i].from_projective(cproj);
+        G2Affine daffine;
+        daffine.from_projective(dproj);
+        d[i].prepare(daffine);
+        prepared_pairs[i].g1 = &c[i];
+        prepared_pairs[i].g2 = &d[i];
+    }
+#endif
+
+    Fq12 expected;
+    pairing_product(expected, affine_pairs, n, prepared_pairs, m);
+
+    for (size_t num_tasks = 0; num_tasks != n + m + 2; num_tasks++) {
+        size_t max_count = 0;
+        Fq12 result;
+        pairing_product_parallel(result, affine_pairs, n, prepared_pairs, m, num_tasks, test_serial_parallel_for, &max_count);
+        if (!Fq12::equal(result, expected)) {
+            return "FAIL (product)";
+        }
+        if (max_count > num_tasks || max_count > n + m) {
+            return "FAIL (too many tasks)";
+        }
+    }
+
+    Fq12 result;
+    pairing_product_parallel(result, nullptr, 0, nullptr, 0, 4, test_serial_parallel_for, nullptr);
+    if (!Fq12::equal(result, Fq12::one)) {
+        return "FAIL (empty)";
+    }
+
+    return "PASS";
+}
+
+const char* test_pairing_prepared_batch(void) {
+#if !defined(__ARM_ARCH_6M__) // Not enough memory on this platform
+    constexpr int n = 4;
+    static MillerTriple coeffs[PreparedBatch::num_coeffs * n];
+    static G2Prepared prepared[n];
+    G1Affine a[n];
+    G2Affine b[n];
+    bool infinity[n];
+    PreparedPair pairs[n];
+
+    PreparedBatch batch;
+    batch.g1 = a;
+    batch.coeffs = coeffs;
+    batch.infinity = infinity;
+    batch.num_pairs = n;
+
+    for (int i = 0; i != std_iters; i++) {
+        for (int j = 0; j != n; j++) {
+            G1 aproj;
+            G2 bproj;
+            aproj.random_generator(random_bytes);
+            bproj.random_generator(random_bytes);
+            a[j].from_projective(aproj);
+            b[j].from_projective(bproj);
+        }
+        a[1].copy(G1Affine::zero);
+        b[2].copy(G2Affine::zero);
+
+        for (int j = 0; j != n; j++) {
+            prepared[j].prepare(b[j]);
+            pairs[j].g1 = &a[j];
+            pairs[j].g2 = &prepared[j];
+            if ((j & 1) == 0) {
+                batch.prepare(j, b[j]);
+            } else {
+                batch.set(j, prepared[j]);
+            }
+        }
+
+        Fq12 expected;
+        pairing_product(expected, nullptr, 0, pairs, n);
+
+        Fq12 result;
+        pairing_product(result, batch);
+        if (!Fq12::equal(result, expected)) {
+            return "FAIL (product)";
+        }
+
+        if (pairing_check(batch)) {
+            return "FAIL (check invalid)";
+        }
+
+        /* e(a0, b0) * e(-a0, b0) * e(0, b1) * e(a2, 0) = 1 */
+        a[1].negate(a[0]);
+        batch.set(1, prepared[0]);
+        a[3].copy(G1Affine::zero);
+        if (!pairing_check(batch)) {
+            return "FAIL (check valid)";
+        }
+    }
+#endif
+
+    return "PASS";
+}
+
+const char* test_pairing_check(void) {
+    G1Affine z1 = G1Affine::zero;
+    G2Affine z2 = G2Affine::zero;
+
+    AffinePair pairs[3];
+    if (!pairing_check(pairs, 0, nullptr, 0)) {
+        return "FAIL (empty)";
+    }
+
+    for (int i = 0; i != std_iters; i++) {
+        G1 a;
+        G2 b;
+        a.random_generator(random_bytes);
+        b.random_generator(random_bytes);
+
+        BigInt<Fr::bits_value> c;
+        Fr cfr;
+        cfr.random(random_bytes);
+        cfr.get(c);
+
+        G1 ac;
+        G2 bc;
+        ac.multiply(a, c);
+        bc.multiply(b, c);
+
+        /* e(a * c, b) * e(-a, b * c) = 1 */
+        G1Affine ac_affine;
+        G2Affine b_affine;
+        G1Affine aneg_affine;
+        G2Affine bc_affine;
+        ac_affine.from_projective(ac);
+        b_affine.from_projective(b);
+        aneg_affine.from_projective(a);
+        aneg_affine.negate(aneg_affine);
+        bc_affine.from_projective(bc);
+
+        pairs[0].g1 = &ac_affine;
+        pairs[0].g2 = &b_affine;
+        pairs[1].g1 = &aneg_affine;
+        pairs[1].g2 = &bc_affine;
+        pairs[2].g1 = &z1;
+        pairs[2].g2 = &b_affine;
+        if (!pairing_check(pairs, 2, nullptr, 0)) {
+            return "FAIL (valid)";
+        }
+        if (!pairing_check(pairs, 3, nullptr, 0)) {
+            return "FAIL (valid with zero)";
+        }
+        if (pairing_check(pairs, 1, nullptr, 0)) {
+            return "FAIL (invalid)";
+        }
+        pairs[1].g1 = &ac_affine;
+        if (pairing_check(pairs, 2, nullptr, 0)) {
+            return "FAIL (invalid pair)";
+        }
+
+        pairs[0].g1 = &ac_affine;
+        pairs[0].g2 = &z2;
+        pairs[1].g1 = &z1;
+        pairs[1].g2 = &bc_affine;
+        if (!pairing_check(pairs, 2, nullptr, 0)) {
+            return "FAIL (zero)";
+        }
+
+#if !defined(__ARM_ARCH_6M__) // Not enough memory on this platform
+        G2Prepared bc_prepared;
+        bc_prepared.prepare(bc_affine);
+
+        PreparedPair prepared;
+        prepared.g1 = &aneg_affine;
+        prepared.g2 = &bc_prepared;
+        pairs[0].g1 = &ac_affine;
+        pairs[0].g2 = &b_affine;
+        if (!pairing_check(pairs, 1, &prepared, 1)) {
+            return "FAIL (prepared valid)";
+        }
+        prepared.g1 = &ac_affine;
+        if (pairing_check(pairs, 1, &prepared, 1)) {
+            return "FAIL (prepared invalid)";
+        }
+#endif
+    }
+
+    return "PASS";
+}
+
+#define TEST_GT_ENCODING(name, g, tmp, encoded) \
+    do { \
+        encoded.encode(g); \
+        if (!encoded.decode(tmp, true)) { \
+            return "FAIL (" name "): could not decode"; \
+        } \
+        if (!Fq12::equal(g, tmp)) { \
+            return "FAIL (" name ")"; \
+        } \
+    } while (0)
+const char* test_gt_encoding(void) {
+    GTUncompressed u;
+    GTCompressed c;
+
+    Fq12 g;
+    Fq12 tmp;
+
+    TEST_GT_ENCODING("one uncompressed", Fq12::one, tmp, u);
+    TEST_GT_ENCODING("one compressed", Fq12::one, tmp, c);
+    TEST_GT_ENCODING("generator compressed", generator_pairing, tmp, c);
+
+    for (int i = 0; i != std_iters; i++) {
+        BigInt<256> power;
+        g.random_gt(power, generator_pairing, random_bytes);
+
+        TEST_GT_ENCODING("uncompressed", g, tmp, u);
+        TEST_GT_ENCODING("compressed", g, tmp, c);
+
+        /* Elements of the cyclotomic subgroup outside of GT are rejected. */
+        g.random(random_bytes);
+        g.map_to_cyclotomic(g);
+        c.encode(g);
+        if (!c.decode(tmp, false) || !Fq12::equal(g, tmp)) {
+            return "FAIL (cyclotomic unchecked)";
+        }
+        if (c.decode(tmp, true)) {
+            return "FAIL (cyclotomic checked)";
+        }
+
+        /* So are arbitrary encodings. */
+        random_bytes(c.data, sizeof(c.data));
+        if (c.decode(tmp, true)) {
+            return "FAIL (random checked)";
+        }
+    }
+
+    return "PASS";
+}
+
 void test_bls12_381_pairing(void) {
     printf("Pairing:\n");
     printf("Generator...\t\t%s\n", test_pairing_generator());
     printf("Zero...\t\t\t%s\n", test_pairing_zero());
     printf("Bilinearity...\t\t%s\n", test_pairing_bilinearity());
     printf("Miller Loop...\t\t%s\n", test_pairing_miller());
+    printf("Batch...\t\t%s\n", test_pairing_batch());
+    printf("Parallel...\t\t%s\n", test_pairing_parallel());
+    printf("Check...\t\t%s\n", test_pairing_check());
+    printf("Prepared Batch...\t%s\n", test_pairing_prepared_batch());
+    printf("GT Encoding...\t\t%s\n", test_gt_encoding());
     printf("\n");
 }
 
@@ -103,6 +103,34 @@ void test_wkdibe_encrypt_decrypt(void) {
     }
 }
 
+void test_wkdibe_encrypt_fixed_base(void) {
+    /* Too large to put on the stack. */
+    static embedded_pairing::bls12_381::GTFixedBaseTable<> table;
+
+    MasterKey msk;
+    setup(p, msk, 10, false, random_bytes);
+    keygen(sk1, p, msk, attrs2, random_bytes);
+    table.fill_table(p.pairing);
+
+    Precomputed precomputed;
+    precompute(precomputed, p, attrs2);
+
+    GT msg;
+    msg.random(random_bytes);
+
+    Ciphertext c;
+    encrypt_precomputed(c, msg, p, precomputed, table, random_bytes);
+
+    GT decrypted;
+    decrypt(decrypted, c, sk1);
+
+    if (GT::equal(msg, decrypted)) {
+        printf("Encrypt (Fixed Base): PASS\n");
+    } else {
+        printf("Encrypt (Fixed Base): FAIL (original/decrypted messages differ)\n");
+    }
+}
+
 void test_wkdibe_qualifykey(void) {
     MasterKey msk;
     setup(p, msk, 10, false, random_bytes);
@@ -187,28 +215,36 @@ void test_wkdibe_sign(void) {
     Signature s;
     sign(s, p, sk1, &attrs3, msg, random_bytes);
 
-    if (verify(p, attrs3, s, msg)) {
-        printf("Sign/Verify: PASS\n");
-    } else {
+    if (!verify(p, attrs3, s, msg)) {
         printf("Sign/Verify: FAIL (valid signature marked invalid)\n");
+        return;
+    }
+
+    Scalar msg2;
+    random_zpstar(msg2, random_bytes);
+    if (verify(p, attrs3, s, msg2)) {
+        printf("Sign/Verify: FAIL (invalid signature marked valid)\n");
+        return;
     }
+
+    printf("Sign/Verify: PASS\n");
 }
 
-template <bool compressed>
+template <bool compressed, bool compressed_gt = false>
 void test_wkdibe_marshal(const char* name) {
     {
         MasterKey msk;
         setup(p, msk, 10, false, random_bytes);
 
         {
-            size_t pbuflen = p.getMarshalledLength<compressed>();
+            size_t pbuflen = p.getMarshalledLength<compressed, compressed_gt>();
             uint8_t pbuf[pbuflen];
-            p.marshal<compressed>(pbuf);
-            if (p.setLength<compressed>(pbuf, pbuflen) == -1) {
+            p.marshal<compressed, compressed_gt>(pbuf);
+            if (p.setLength<compressed, compressed_gt>(pbuf, pbuflen) == -1) {
                 printf("%s: FAIL (could not set length for params)\n", name);
                 return;
             }
-            if (!p.unmarshal<compressed>(pbuf, true)) {
+            if (!p.unmarshal<compressed, compressed_gt>(pbuf, true)) {
                 printf("%s: FAIL (could not unmarshal params)\n", name);
                 return;
             }
@@ -258,15 +294,20 @@ void test_wkdibe_marshal(const char* name) {
 
     {
         GT msg;
-        msg.random(random_bytes);
+        if constexpr(compressed_gt) {
+            /* The compressed encoding only works for elements of GT. */
+            random_gt(msg, random_bytes);
+        } else {
+            msg.random(random_bytes);
+        }
 
         Ciphertext c;
         encrypt(c, msg, p, attrs2, random_bytes);
 
         {
-            uint8_t cbuf[Ciphertext::marshalledLength<compressed>];
-            c.marshal<compressed>(cbuf);
-            if (!c.unmarshal<compressed>(cbuf, true)) {
+            uint8_t cbuf[Ciphertext::marshalledLength<compressed, compressed_gt>];
+            c.marshal<compressed, compressed_gt>(cbuf);
+            if (!c.unmarshal<compressed, compressed_gt>(cbuf, true)) {
                 printf("%s: FAIL (could not unmarshal ciphertext)\n", name);
                 return;
             }
@@ -315,11 +356,14 @@ void run_wkdibe_tests() {
 
     test_wkdibe_encrypt_decrypt_master();
     test_wkdibe_encrypt_decrypt();
+    test_wkdibe_encrypt_fixed_base();
     test_wkdibe_qualifykey();
     test_wkdibe_nondelegablekey();
     test_wkdibe_adjust();
     test_wkdibe_sign();
     test_wkdibe_marshal<true>("Marshal Compressed");
     test_wkdibe_marshal<false>("Marshal Uncompressed");
+    test_wkdibe_marshal<true, true>("Marshal Compressed (Compressed GT)");
+    test_wkdibe_marshal<false, true>("Marshal Uncompressed (Compressed GT)");
     printf("DONE\n");
 }